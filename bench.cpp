@@ -0,0 +1,285 @@
+// замеры производительности основных функций всех пяти программ
+// сборка: g++ -std=c++20 -O2 -pthread bench.cpp liblr3.a -o bench
+// запуск: ./bench [--reps N] [--warmup N] [--quick] [--filter подстрока]
+//                 [--out результаты.json] [--baseline прошлые.json] [--threshold 0.1]
+// каждая функция вызывается напрямую на входах нескольких размеров, после прогрева
+// выполняется reps повторов и выводятся процентили времени одного повтора.
+// результаты пишутся в json, при заданном baseline медианы сравниваются с ним,
+// и замедление больше threshold отмечается как регрессия (код выхода 1)
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <numeric>
+#include <random>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include "lr3lib.h"
+
+using namespace std;
+
+// результат замера одной функции на одном размере входа
+struct BenchResult {
+    string name;
+    long long size;
+    double p50, p90, p99, mean; // время одного повтора, нс
+};
+
+// параметры запуска
+struct BenchOptions {
+    int reps = 20;
+    int warmup = 3;
+    bool quick = false;
+    string filter;
+};
+
+// не дает компилятору выбросить вычисления, результат которых не используется
+volatile double sink;
+
+// процентиль по отсортированным замерам
+double percentile(const vector<double>& sorted, double p) {
+    size_t index = static_cast<size_t>(ceil(p * sorted.size())) - 1;
+    return sorted[min(index, sorted.size() - 1)];
+}
+
+// дополняет текст пробелами до width символов (для utf-8 считаются символы, а не байты)
+string pad(const string& text, size_t width, bool left) {
+    size_t chars = count_if(text.begin(), text.end(), [](char c) { return (c & 0xC0) != 0x80; });
+    string spaces(width > chars ? width - chars : 0, ' ');
+    return left ? text + spaces : spaces + text;
+}
+
+// замеряет run: warmup прогревочных вызовов, затем reps замеренных
+void measure(vector<BenchResult>& results, const BenchOptions& options,
+             const string& name, long long size, const function<void()>& run) {
+    if (!options.filter.empty() && name.find(options.filter) == string::npos) return;
+
+    for (int i = 0; i < options.warmup; ++i) run();
+    vector<double> samples;
+    for (int i = 0; i < options.reps; ++i) {
+        auto start = chrono::steady_clock::now();
+        run();
+        auto stop = chrono::steady_clock::now();
+        samples.push_back(chrono::duration<double, nano>(stop - start).count());
+    }
+    sort(samples.begin(), samples.end());
+
+    BenchResult res{name, size, percentile(samples, 0.5), percentile(samples, 0.9),
+                    percentile(samples, 0.99),
+                    accumulate(samples.begin(), samples.end(), 0.0) / samples.size()};
+    cout << left << setw(22) << name << right << setw(11) << size
+         << fixed << setprecision(1)
+         << setw(14) << res.p50 / 1000 << setw(14) << res.p90 / 1000
+         << setw(14) << res.p99 / 1000 << setw(14) << res.mean / 1000 << "\n";
+    results.push_back(res);
+}
+
+// запускает все замеры
+vector<BenchResult> runAll(const BenchOptions& options) {
+    vector<BenchResult> results;
+    mt19937 gen(12345); // фиксированное зерно, чтобы входы совпадали между запусками
+    vector<long long> sizes = options.quick ? vector<long long>{10000, 100000}
+                                            : vector<long long>{100000, 1000000};
+    string tempDir = filesystem::temp_directory_path().string();
+
+    cout << pad("функция", 22, true) << pad("размер", 11, false)
+         << pad("p50, мкс", 14, false) << pad("p90, мкс", 14, false)
+         << pad("p99, мкс", 14, false) << pad("среднее, мкс", 14, false) << "\n";
+
+    // lr3-1: значение кусочной функции на равномерной сетке
+    for (long long n : sizes) {
+        measure(results, options, "calculateY", n, [n]() {
+            double sum = 0;
+            for (long long i = 0; i < n; ++i) sum += lr3::calculateY(-5.0 + 10.0 * i / n);
+            sink = sum;
+        });
+    }
+
+    // lr3-2: возведение в степень, тест миллера-рабина и решето
+    for (long long n : sizes) {
+        uniform_int_distribution<int> dist(3, 46339);
+        vector<int> moduli(n), bases(n), exps(n);
+        for (long long i = 0; i < n; ++i) {
+            moduli[i] = dist(gen) | 1;
+            bases[i] = dist(gen);
+            exps[i] = dist(gen);
+        }
+        measure(results, options, "modPow", n, [&, n]() {
+            long long sum = 0;
+            for (long long i = 0; i < n; ++i) sum += lr3::modPow(bases[i], exps[i], moduli[i]);
+            sink = sum;
+        });
+        measure(results, options, "millerRabinTest", n, [&, n]() {
+            long long sum = 0;
+            for (long long i = 0; i < n; ++i) {
+                sum += lr3::MillerPrimality::millerRabinTest(moduli[i], 5, gen);
+            }
+            sink = sum;
+        });
+    }
+    for (long long n : sizes) {
+        long long limit = n * 10;
+        measure(results, options, "sieveOfEratosthenes", limit, [limit]() {
+            sink = lr3::sieveOfEratosthenes(limit).size();
+        });
+    }
+
+    // lr3-3: сумма ряда, время растет экспоненциально от степени.
+    // основание 2, потому что для больших оснований int переполняется уже при степени 10
+    for (int power : {5, 10}) {
+        measure(results, options, "computeSeriesSum", power, [power]() {
+            sink = lr3::computeSeriesSum(power, 2).first;
+        });
+    }
+
+    // lr3-4: победитель игры
+    for (long long n : sizes) {
+        uniform_int_distribution<int> dist(-1000, 1000);
+        vector<int> nums(n);
+        for (auto& x : nums) x = dist(gen);
+        lr3::WinnerArena arena;
+        measure(results, options, "findWinner", n, [&, n]() {
+            sink = lr3::findWinner(n, 100, nums.data(), arena);
+        });
+    }
+
+    // lr3-5: моделирование, статистика и запись в файл
+    for (long long n : sizes) {
+        double time = 100.0, step = time / n;
+        lr3::CoolingData data;
+        measure(results, options, "cofe", n, [&]() {
+            lr3::cofe(90, 20, 0.1, time, step, data);
+            sink = data.temp.back();
+        });
+        measure(results, options, "korrel", n, [&]() {
+            double r, r2;
+            lr3::korrel(data, r, r2);
+            sink = r;
+        });
+        measure(results, options, "aprox", n, [&]() {
+            double a, b;
+            lr3::aprox(data, a, b);
+            sink = a;
+        });
+        string csvPath = tempDir + "/lr3_bench.csv";
+        string binPath = tempDir + "/lr3_bench.bin";
+        measure(results, options, "writeToFile.csv", n, [&]() {
+            sink = lr3::writeCsv(data, csvPath);
+        });
+        measure(results, options, "writeToFile.bin", n, [&]() {
+            sink = lr3::writeBinary(data, binPath);
+        });
+        filesystem::remove(csvPath);
+        filesystem::remove(binPath);
+    }
+
+    return results;
+}
+
+// сохраняет результаты в json
+bool writeJson(const vector<BenchResult>& results, const string& filename) {
+    ofstream out(filename);
+    if (!out.is_open()) return false;
+    out << "{\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        out << fixed << setprecision(1)
+            << "    {\"name\": \"" << r.name << "\", \"size\": " << r.size
+            << ", \"p50_ns\": " << r.p50 << ", \"p90_ns\": " << r.p90
+            << ", \"p99_ns\": " << r.p99 << ", \"mean_ns\": " << r.mean << "}"
+            << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n}\n";
+    return out.good();
+}
+
+// читает медианы из json, записанного writeJson: ключ "имя/размер"
+bool readBaseline(const string& filename, map<string, double>& medians) {
+    ifstream in(filename);
+    if (!in.is_open()) return false;
+    string text((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    regex entry(R"re(\{"name":\s*"([^"]+)",\s*"size":\s*(\d+),\s*"p50_ns":\s*([0-9.eE+-]+))re");
+    for (sregex_iterator it(text.begin(), text.end(), entry), end; it != end; ++it) {
+        medians[(*it)[1].str() + "/" + (*it)[2].str()] = stod((*it)[3].str());
+    }
+    return true;
+}
+
+// сравнивает медианы с прошлыми, возвращает количество регрессий
+int compareWithBaseline(const vector<BenchResult>& results,
+                        const map<string, double>& baseline, double threshold) {
+    int regressions = 0;
+    cout << "\nсравнение с прошлыми результатами (порог " << threshold * 100 << "%):\n";
+    for (const auto& r : results) {
+        auto it = baseline.find(r.name + "/" + to_string(r.size));
+        if (it == baseline.end()) continue;
+        double change = r.p50 / it->second - 1;
+        bool regression = change > threshold;
+        regressions += regression;
+        cout << left << setw(22) << r.name << right << setw(11) << r.size
+             << setw(10) << showpos << setprecision(1) << change * 100 << "%" << noshowpos
+             << (regression ? "  регрессия" : "") << "\n";
+    }
+    return regressions;
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    string outFile = "bench_results.json";
+    string baselineFile;
+    double threshold = 0.10;
+
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--reps" && hasValue) {
+            options.reps = max(1, stoi(argv[++i]));
+        } else if (arg == "--warmup" && hasValue) {
+            options.warmup = max(0, stoi(argv[++i]));
+        } else if (arg == "--quick") {
+            options.quick = true;
+        } else if (arg == "--filter" && hasValue) {
+            options.filter = argv[++i];
+        } else if (arg == "--out" && hasValue) {
+            outFile = argv[++i];
+        } else if (arg == "--baseline" && hasValue) {
+            baselineFile = argv[++i];
+        } else if (arg == "--threshold" && hasValue) {
+            threshold = stod(argv[++i]);
+        } else {
+            cout << "неизвестный параметр: " << arg << endl;
+            return 2;
+        }
+    }
+
+    // прошлые результаты читаются до замеров, out может совпадать с baseline
+    map<string, double> baseline;
+    if (!baselineFile.empty() && !readBaseline(baselineFile, baseline)) {
+        cout << "ошибка при чтении файла " << baselineFile << endl;
+        return 2;
+    }
+
+    vector<BenchResult> results = runAll(options);
+
+    if (!writeJson(results, outFile)) {
+        cout << "ошибка при записи файла " << outFile << endl;
+        return 2;
+    }
+    cout << "результаты сохранены в файл: " << outFile << endl;
+
+    if (!baselineFile.empty()) {
+        int regressions = compareWithBaseline(results, baseline, threshold);
+        cout << "регрессий: " << regressions << endl;
+        return regressions > 0 ? 1 : 0;
+    }
+    return 0;
+}
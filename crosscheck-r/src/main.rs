@@ -0,0 +1,301 @@
+// драйвер сверки для crosscheck.cpp: подключает исходники rust-версий программ
+// и считает на них те же ядра на тех же входах, что и c++-версия.
+// запуск: crosscheck-r [--seed N] [--scale N] [--reps N]
+// для каждого ядра выводится строка "kernel имя входов наносекунды",
+// затем строка с результатами через пробел
+#![allow(dead_code, unused_imports, unused_variables, unused_mut, non_snake_case)]
+
+use std::env;
+use std::io::{self, BufWriter, Write};
+use std::time::Instant;
+
+// генератор входных данных splitmix64, тот же, что в crosscheck.cpp
+struct SplitMix64(u64);
+
+impl SplitMix64 {
+    fn next(&mut self) -> u64 {
+        self.0 = self.0.wrapping_add(0x9e3779b97f4a7c15);
+        let mut z = self.0;
+        z = (z ^ (z >> 30)).wrapping_mul(0xbf58476d1ce4e5b9);
+        z = (z ^ (z >> 27)).wrapping_mul(0x94d049bb133111eb);
+        z ^ (z >> 31)
+    }
+
+    // целое в [lo, hi]
+    fn range(&mut self, lo: i64, hi: i64) -> i64 {
+        lo + (self.next() % (hi - lo + 1) as u64) as i64
+    }
+
+    // вещественное в [0, 1)
+    fn unit(&mut self) -> f64 {
+        (self.next() >> 11) as f64 / 9007199254740992.0
+    }
+}
+
+mod lr31 {
+    include!("../../lr3-1r.rs");
+
+    pub fn calculate(x: f64) -> f64 {
+        calculate_y(x)
+    }
+}
+
+mod lr32 {
+    // заменитель крейта rand с тем же интерфейсом, что использует lr3-2r:
+    // драйвер собирается без зависимостей, а последовательность задается зерном
+    mod rand {
+        use std::cell::Cell;
+        use std::ops::{Range, RangeInclusive};
+
+        thread_local! {
+            static STATE: Cell<u64> = Cell::new(0);
+        }
+
+        pub fn seed(value: u64) {
+            STATE.with(|s| s.set(value));
+        }
+
+        fn next() -> u64 {
+            STATE.with(|s| {
+                let mut rng = super::super::SplitMix64(s.get());
+                let value = rng.next();
+                s.set(rng.0);
+                value
+            })
+        }
+
+        pub struct ThreadRng;
+
+        pub fn thread_rng() -> ThreadRng {
+            ThreadRng
+        }
+
+        pub trait SampleRange<T> {
+            fn sample(self) -> T;
+        }
+
+        macro_rules! int_ranges {
+            ($($t:ty),*) => {$(
+                impl SampleRange<$t> for Range<$t> {
+                    fn sample(self) -> $t {
+                        assert!(self.start < self.end, "пустой диапазон");
+                        self.start + (next() % (self.end - self.start) as u64) as $t
+                    }
+                }
+
+                impl SampleRange<$t> for RangeInclusive<$t> {
+                    fn sample(self) -> $t {
+                        let (lo, hi) = self.into_inner();
+                        lo + (next() % ((hi - lo) as u64 + 1)) as $t
+                    }
+                }
+            )*};
+        }
+
+        int_ranges!(u32, u64, usize);
+
+        impl SampleRange<f64> for Range<f64> {
+            fn sample(self) -> f64 {
+                self.start + (next() >> 11) as f64 / 9007199254740992.0 * (self.end - self.start)
+            }
+        }
+
+        pub trait Rng {
+            fn gen_range<T, R: SampleRange<T>>(&mut self, range: R) -> T {
+                range.sample()
+            }
+        }
+
+        impl Rng for ThreadRng {}
+    }
+
+    include!("../../lr3-2r/src/main.rs");
+
+    pub fn seed(value: u64) {
+        rand::seed(value);
+    }
+
+    pub fn power(base: u64, exponent: u64, modulus: u64) -> u64 {
+        mod_pow(base, exponent, modulus)
+    }
+
+    pub fn sieve(n: usize) -> Vec<u64> {
+        sieve_of_eratosthenes(n)
+    }
+
+    pub fn miller_rabin(num: u64, tests: usize) -> bool {
+        PocklingtonPrimality::miller_rabin_test(num, tests)
+    }
+
+    // цикл генерации из generate_primes без вывода
+    pub fn pocklington(bits: usize, tests: usize, count: usize) -> Vec<u64> {
+        let primes = sieve_of_eratosthenes(500);
+        let mut found = Vec::new();
+        while found.len() < count {
+            let (n, factors) = PocklingtonPrimality::generate_candidate(&primes, bits);
+            if PocklingtonPrimality::is_prime(n, tests, &factors) {
+                found.push(n);
+            }
+        }
+        found
+    }
+
+    pub fn miller(bits: usize, tests: usize, count: usize) -> Vec<u64> {
+        let primes = sieve_of_eratosthenes(500);
+        let mut found = Vec::new();
+        while found.len() < count {
+            let (n, factors) = MillerPrimality::generate_candidate(&primes, bits);
+            if MillerPrimality::is_prime(n, tests, &factors) {
+                found.push(n);
+            }
+        }
+        found
+    }
+
+    pub fn gost(bits: usize, rounds: usize, count: usize) -> Vec<u64> {
+        let primes = sieve_of_eratosthenes(500);
+        let mut found = Vec::new();
+        while found.len() < count {
+            let p = GOSTPrimality::generate_prime(&primes, bits);
+            if GOSTPrimality::miller_rabin_test(p, rounds) {
+                found.push(p);
+            }
+        }
+        found
+    }
+}
+
+mod lr33 {
+    include!("../../lr3-3r.rs");
+
+    pub fn series(power: i32, base: i32) -> (i32, i32) {
+        compute_series_sum(power, base)
+    }
+}
+
+mod lr34 {
+    include!("../../lr3-4r.rs");
+
+    pub fn winner(n: usize, m: usize, nums: &Vec<i32>) -> i32 {
+        find_winner(n, m, nums)
+    }
+}
+
+// прогоняет run reps раз, возвращает результаты последнего прогона и лучшее время
+fn measure<T>(reps: usize, mut run: impl FnMut() -> T) -> (T, u128) {
+    let mut best = u128::MAX;
+    let mut result = None;
+    for _ in 0..reps {
+        let start = Instant::now();
+        let value = run();
+        best = best.min(start.elapsed().as_nanos());
+        result = Some(value);
+    }
+    (result.unwrap(), best)
+}
+
+fn report(out: &mut impl Write, name: &str, items: usize, nanos: u128, values: &[String]) {
+    writeln!(out, "kernel {} {} {}", name, items, nanos).unwrap();
+    writeln!(out, "{}", values.join(" ")).unwrap();
+}
+
+fn main() {
+    let mut seed: u64 = 1;
+    let mut scale: usize = 100000;
+    let mut reps: usize = 3;
+    let args: Vec<String> = env::args().collect();
+    let mut i = 1;
+    while i + 1 < args.len() {
+        match args[i].as_str() {
+            "--seed" => seed = args[i + 1].parse().expect("некорректное зерно"),
+            "--scale" => scale = args[i + 1].parse().expect("некорректный размер"),
+            "--reps" => reps = args[i + 1].parse::<usize>().expect("некорректное число повторов").max(1),
+            other => panic!("неизвестный параметр: {}", other),
+        }
+        i += 2;
+    }
+
+    let stdout = io::stdout();
+    let mut out = BufWriter::new(stdout.lock());
+
+    // lr3-1: значение кусочной функции
+    let mut rng = SplitMix64(seed);
+    let xs: Vec<f64> = (0..scale).map(|_| -6.0 + 12.0 * rng.unit()).collect();
+    let (ys, nanos) = measure(reps, || xs.iter().map(|&x| lr31::calculate(x)).collect::<Vec<f64>>());
+    let values: Vec<String> = ys
+        .iter()
+        .map(|y| if y.is_nan() { "nan".to_string() } else { format!("{:016x}", y.to_bits()) })
+        .collect();
+    report(&mut out, "calculateY", scale, nanos, &values);
+
+    // lr3-2: возведение в степень по модулю
+    let mut rng = SplitMix64(seed + 1);
+    let triples: Vec<(u64, u64, u64)> = (0..scale)
+        .map(|_| {
+            let base = rng.range(0, i32::MAX as i64) as u64;
+            let exponent = rng.range(0, i32::MAX as i64) as u64;
+            let modulus = rng.range(2, i32::MAX as i64) as u64;
+            (base, exponent, modulus)
+        })
+        .collect();
+    let (powers, nanos) = measure(reps, || {
+        triples.iter().map(|&(b, e, m)| lr32::power(b, e, m)).collect::<Vec<u64>>()
+    });
+    report(&mut out, "modPow", scale, nanos, &powers.iter().map(|v| v.to_string()).collect::<Vec<_>>());
+
+    // решето эратосфена
+    let limit = scale * 10;
+    let (primes, nanos) = measure(reps, || lr32::sieve(limit));
+    report(&mut out, "sieveOfEratosthenes", limit, nanos,
+           &primes.iter().map(|v| v.to_string()).collect::<Vec<_>>());
+
+    // тест миллера-рабина на нечетных числах
+    let mut rng = SplitMix64(seed + 3);
+    let odds: Vec<u64> = (0..scale).map(|_| (rng.range(5, i32::MAX as i64) | 1) as u64).collect();
+    lr32::seed(seed + 3);
+    let (verdicts, nanos) = measure(reps, || {
+        odds.iter().map(|&n| lr32::miller_rabin(n, 20)).collect::<Vec<bool>>()
+    });
+    report(&mut out, "millerRabinTest", scale, nanos,
+           &verdicts.iter().map(|&v| (v as u8).to_string()).collect::<Vec<_>>());
+
+    // lr3-3: сумма ряда, степень до 5 (выше int переполняется в обеих версиях)
+    let mut rng = SplitMix64(seed + 4);
+    let count = (scale / 100).max(1);
+    let pairs: Vec<(i32, i32)> = (0..count).map(|_| (rng.range(0, 5) as i32, rng.range(2, 10) as i32)).collect();
+    let (sums, nanos) = measure(reps, || {
+        pairs.iter().map(|&(p, b)| lr33::series(p, b)).collect::<Vec<(i32, i32)>>()
+    });
+    report(&mut out, "computeSeriesSum", count, nanos,
+           &sums.iter().map(|(n, d)| format!("{}/{}", n, d)).collect::<Vec<_>>());
+
+    // lr3-4: победители игр
+    let mut rng = SplitMix64(seed + 5);
+    let count = (scale / 1000).max(1);
+    let games: Vec<(usize, usize, Vec<i32>)> = (0..count)
+        .map(|_| {
+            let n = rng.range(1, 2000) as usize;
+            let m = rng.range(1, 100) as usize;
+            let nums = (0..n).map(|_| rng.range(-1000, 1000) as i32).collect();
+            (n, m, nums)
+        })
+        .collect();
+    let (winners, nanos) = measure(reps, || {
+        games.iter().map(|(n, m, nums)| lr34::winner(*n, *m, nums)).collect::<Vec<i32>>()
+    });
+    report(&mut out, "findWinner", count, nanos,
+           &winners.iter().map(|v| v.to_string()).collect::<Vec<_>>());
+
+    // генераторы простых чисел: параметры из меню lr3-2, для гост 14 бит
+    let count = (scale / 1000).max(1);
+    let generators: [(&str, fn(usize, usize, usize) -> Vec<u64>, usize, usize); 3] = [
+        ("pocklington", lr32::pocklington, 13, 10),
+        ("miller", lr32::miller, 10, 5),
+        ("gost", lr32::gost, 14, 3),
+    ];
+    for (k, (name, generate, bits, tests)) in generators.iter().enumerate() {
+        lr32::seed(seed + 6 + k as u64);
+        let (found, nanos) = measure(reps, || generate(*bits, *tests, count));
+        report(&mut out, name, count, nanos, &found.iter().map(|v| v.to_string()).collect::<Vec<_>>());
+    }
+}
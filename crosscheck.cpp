@@ -0,0 +1,551 @@
+// сверка c++ и rust версий программ на одних и тех же входах
+// сборка: g++ -std=c++20 -O2 -pthread crosscheck.cpp liblr3.a -o crosscheck
+//         cargo build --release --manifest-path crosscheck-r/Cargo.toml
+// запуск: ./crosscheck [--rust путь] [--seed N] [--scale N] [--reps N]
+// входы каждого ядра строятся генератором splitmix64 от одного зерна на обеих сторонах,
+// rust-драйвер запускается отдельным процессом и выводит свои результаты и время.
+// детерминированные ядра сравниваются поэлементно, у генераторов простых чисел
+// случайные последовательности разные, поэтому проверяется, что все числа простые.
+// ядра, у которых нет rust-версии, сверяются с эталонной c++ реализацией.
+// выводится время и пропускная способность обеих версий, код выхода 1 при расхождениях
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "lr3lib.h"
+
+using namespace std;
+using namespace lr3;
+
+// генератор входных данных splitmix64, тот же, что в crosscheck-r
+struct SplitMix64 {
+    uint64_t state;
+
+    uint64_t next() {
+        state += 0x9e3779b97f4a7c15ULL;
+        uint64_t z = state;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    // целое в [lo, hi]
+    long long range(long long lo, long long hi) {
+        return lo + static_cast<long long>(next() % static_cast<uint64_t>(hi - lo + 1));
+    }
+
+    // вещественное в [0, 1)
+    double unit() {
+        return (next() >> 11) / 9007199254740992.0;
+    }
+};
+
+// результаты одного ядра
+struct KernelRun {
+    long long items = 0;
+    double nanos = 0;
+    vector<string> values;
+};
+
+// как сравнивать результаты ядра
+enum class Check {
+    Exact,  // поэлементное совпадение
+    Primes, // все числа простые (случайные последовательности у версий разные)
+    Local   // совпадение с эталонной c++ реализацией, rust-версии нет
+};
+
+struct Kernel {
+    string name;
+    Check check;
+    KernelRun cpp;
+    vector<string> inputs;     // входы для сообщения о первом расхождении
+    vector<string> reference;  // ожидаемые значения для Check::Local
+};
+
+// прогоняет body reps раз, возвращает результат последнего прогона, лучшее время пишет в run
+template <typename Body>
+auto measure(KernelRun& run, int reps, Body body) {
+    run.nanos = 1e300;
+    decltype(body()) result;
+    for (int i = 0; i < reps; ++i) {
+        auto start = chrono::steady_clock::now();
+        result = body();
+        auto stop = chrono::steady_clock::now();
+        run.nanos = min(run.nanos, chrono::duration<double, nano>(stop - start).count());
+    }
+    return result;
+}
+
+template <typename T>
+vector<string> toStrings(const vector<T>& values) {
+    vector<string> out;
+    out.reserve(values.size());
+    for (const T& v : values) out.push_back(to_string(v));
+    return out;
+}
+
+// считает все ядра на c++ стороне, входы такие же, как в crosscheck-r
+vector<Kernel> runCpp(uint64_t seed, long long scale, int reps) {
+    vector<Kernel> kernels;
+
+    // lr3-1: значение кусочной функции, сравниваются биты double
+    {
+        Kernel k{"calculateY", Check::Exact, {}, {}, {}};
+        SplitMix64 rng{seed};
+        vector<double> xs(scale);
+        for (auto& x : xs) x = -6.0 + 12.0 * rng.unit();
+        vector<double> ys = measure(k.cpp, reps, [&]() {
+            vector<double> out(xs.size());
+            for (size_t i = 0; i < xs.size(); ++i) out[i] = calculateY(xs[i]);
+            return out;
+        });
+        for (double y : ys) {
+            if (isnan(y)) {
+                k.cpp.values.push_back("nan");
+                continue;
+            }
+            char text[17];
+            snprintf(text, sizeof(text), "%016llx", static_cast<unsigned long long>(bit_cast<uint64_t>(y)));
+            k.cpp.values.push_back(text);
+        }
+        for (double x : xs) k.inputs.push_back("x=" + to_string(x));
+        k.cpp.items = scale;
+        kernels.push_back(move(k));
+    }
+
+    // lr3-2: возведение в степень по модулю на всем диапазоне int
+    {
+        Kernel k{"modPow", Check::Exact, {}, {}, {}};
+        SplitMix64 rng{seed + 1};
+        vector<int> bases(scale), exps(scale), moduli(scale);
+        for (long long i = 0; i < scale; ++i) {
+            bases[i] = rng.range(0, INT32_MAX);
+            exps[i] = rng.range(0, INT32_MAX);
+            moduli[i] = rng.range(2, INT32_MAX);
+        }
+        k.cpp.values = toStrings(measure(k.cpp, reps, [&]() {
+            vector<int> out(scale);
+            for (long long i = 0; i < scale; ++i) out[i] = modPow(bases[i], exps[i], moduli[i]);
+            return out;
+        }));
+        for (long long i = 0; i < scale; ++i) {
+            k.inputs.push_back(to_string(bases[i]) + "^" + to_string(exps[i]) + " mod " + to_string(moduli[i]));
+        }
+        k.cpp.items = scale;
+        kernels.push_back(move(k));
+    }
+
+    // решето эратосфена, сравнивается весь список простых
+    {
+        Kernel k{"sieveOfEratosthenes", Check::Exact, {}, {}, {}};
+        int limit = scale * 10;
+        k.cpp.values = toStrings(measure(k.cpp, reps, [&]() { return sieveOfEratosthenes(limit); }));
+        k.cpp.items = limit;
+        kernels.push_back(move(k));
+    }
+
+    // тест миллера-рабина: 20 раундов, вероятность ошибки на составном не больше 4^-20
+    {
+        Kernel k{"millerRabinTest", Check::Exact, {}, {}, {}};
+        SplitMix64 rng{seed + 3};
+        vector<int> odds(scale);
+        for (auto& n : odds) n = rng.range(5, INT32_MAX) | 1;
+        mt19937 gen(seed + 3);
+        k.cpp.values = toStrings(measure(k.cpp, reps, [&]() {
+            vector<int> out(scale);
+            for (long long i = 0; i < scale; ++i) out[i] = MillerPrimality::millerRabinTest(odds[i], 20, gen);
+            return out;
+        }));
+        for (int n : odds) k.inputs.push_back("n=" + to_string(n));
+        k.cpp.items = scale;
+        kernels.push_back(move(k));
+    }
+
+    // lr3-3: сумма ряда, степень до 5 (выше int переполняется в обеих версиях)
+    {
+        Kernel k{"computeSeriesSum", Check::Exact, {}, {}, {}};
+        SplitMix64 rng{seed + 4};
+        long long count = max(1LL, scale / 100);
+        vector<pair<int, int>> pairs(count);
+        for (auto& [power, base] : pairs) {
+            power = rng.range(0, 5);
+            base = rng.range(2, 10);
+        }
+        vector<pair<int, int>> sums = measure(k.cpp, reps, [&]() {
+            vector<pair<int, int>> out(count);
+            for (long long i = 0; i < count; ++i) out[i] = computeSeriesSum(pairs[i].first, pairs[i].second);
+            return out;
+        });
+        for (auto [num, den] : sums) k.cpp.values.push_back(to_string(num) + "/" + to_string(den));
+        for (auto [power, base] : pairs) k.inputs.push_back(to_string(power) + " " + to_string(base));
+        k.cpp.items = count;
+        kernels.push_back(move(k));
+    }
+
+    // lr3-4: победители игр
+    {
+        Kernel k{"findWinner", Check::Exact, {}, {}, {}};
+        SplitMix64 rng{seed + 5};
+        long long count = max(1LL, scale / 1000);
+        vector<pair<int, int>> shapes(count);
+        vector<vector<int>> games(count);
+        for (long long g = 0; g < count; ++g) {
+            int n = rng.range(1, 2000);
+            int m = rng.range(1, 100);
+            shapes[g] = {n, m};
+            games[g].resize(n);
+            for (auto& x : games[g]) x = rng.range(-1000, 1000);
+        }
+        WinnerArena arena;
+        k.cpp.values = toStrings(measure(k.cpp, reps, [&]() {
+            vector<int> out(count);
+            for (long long g = 0; g < count; ++g) {
+                out[g] = findWinner(shapes[g].first, shapes[g].second, games[g].data(), arena);
+            }
+            return out;
+        }));
+        for (auto [n, m] : shapes) k.inputs.push_back("n=" + to_string(n) + " m=" + to_string(m));
+        k.cpp.items = count;
+        kernels.push_back(move(k));
+    }
+
+    // генераторы простых чисел: параметры из меню lr3-2, для гост 14 бит.
+    // повторяется цикл generatePrimes без сертификатов и дополнительной проверки
+    long long count = max(1LL, scale / 1000);
+    const vector<int>& primes = smallPrimes();
+    {
+        Kernel k{"pocklington", Check::Primes, {}, {}, {}};
+        mt19937 gen(seed + 6);
+        k.cpp.values = toStrings(measure(k.cpp, reps, [&]() {
+            vector<int> found;
+            while (static_cast<long long>(found.size()) < count) {
+                auto [n, factors] = PocklingtonPrimality::generateCandidate(primes, 13, gen);
+                if (PocklingtonPrimality::isPrime(n, 10, factors, gen)) found.push_back(n);
+            }
+            return found;
+        }));
+        k.cpp.items = count;
+        kernels.push_back(move(k));
+    }
+    {
+        Kernel k{"miller", Check::Primes, {}, {}, {}};
+        mt19937 gen(seed + 7);
+        k.cpp.values = toStrings(measure(k.cpp, reps, [&]() {
+            vector<int> found;
+            while (static_cast<long long>(found.size()) < count) {
+                auto [n, factors] = MillerPrimality::generateCandidate(primes, 10, gen);
+                if (MillerPrimality::isPrime(n, 5, factors, gen)) found.push_back(n);
+            }
+            return found;
+        }));
+        k.cpp.items = count;
+        kernels.push_back(move(k));
+    }
+    {
+        Kernel k{"gost", Check::Primes, {}, {}, {}};
+        mt19937 gen(seed + 8);
+        k.cpp.values = toStrings(measure(k.cpp, reps, [&]() {
+            vector<int> found;
+            while (static_cast<long long>(found.size()) < count) {
+                int p = GOSTPrimality::generatePrime(primes, 14, gen);
+                if (MillerPrimality::millerRabinTest(p, 3, gen)) found.push_back(p);
+            }
+            return found;
+        }));
+        k.cpp.items = count;
+        kernels.push_back(move(k));
+    }
+
+    // lr3-4, режим изменений: ответы DynamicGame после случайных замен чисел
+    // сверяются с findWinner на текущей последовательности
+    {
+        Kernel k{"DynamicGame", Check::Local, {}, {}, {}};
+        SplitMix64 rng{seed + 9};
+        long long games = 10;
+        long long ops = max(1LL, scale / 100);
+        struct Operation {
+            int index; // -1 означает запрос победителя
+            int value;
+        };
+        vector<pair<int, int>> shapes(games);
+        vector<vector<int>> starts(games);
+        vector<vector<Operation>> operations(games);
+        for (long long g = 0; g < games; ++g) {
+            int n = rng.range(1, 2000);
+            int m = rng.range(1, 100);
+            shapes[g] = {n, m};
+            starts[g].resize(n);
+            for (auto& x : starts[g]) x = rng.range(-1000, 1000);
+            operations[g].resize(ops);
+            for (auto& op : operations[g]) {
+                // замен больше, чем запросов, чтобы проверить несколько замен перед пересчетом
+                if (rng.range(0, 2) == 0) {
+                    op = {-1, 0};
+                } else {
+                    op.index = rng.range(0, n - 1);
+                    op.value = rng.range(-1000, 1000);
+                }
+            }
+        }
+
+        k.cpp.values = toStrings(measure(k.cpp, reps, [&]() {
+            vector<int> out;
+            for (long long g = 0; g < games; ++g) {
+                DynamicGame game(shapes[g].second, starts[g]);
+                for (const Operation& op : operations[g]) {
+                    if (op.index < 0) {
+                        out.push_back(game.query());
+                    } else {
+                        game.update(op.index, op.value);
+                    }
+                }
+            }
+            return out;
+        }));
+
+        WinnerArena arena;
+        for (long long g = 0; g < games; ++g) {
+            vector<int> nums = starts[g];
+            for (long long q = 0; q < ops; ++q) {
+                const Operation& op = operations[g][q];
+                if (op.index >= 0) {
+                    nums[op.index] = op.value;
+                    continue;
+                }
+                k.reference.push_back(to_string(findWinner(shapes[g].first, shapes[g].second, nums.data(), arena)));
+                k.inputs.push_back("игра " + to_string(g) + ", операция " + to_string(q));
+            }
+        }
+        k.cpp.items = games * ops;
+        kernels.push_back(move(k));
+    }
+
+    // lr3-2, сертификаты поклингтона: для случайных простых сертификат строится
+    // по полному разложению n-1 и должен приниматься, для составных n
+    // сертификаты со случайными основаниями должны отвергаться.
+    // отдельно проверяются сертификаты составных чисел, которые принимала
+    // проверка с переполнением int в modPow
+    {
+        Kernel k{"verifyCertificate", Check::Local, {}, {}, {}};
+        const vector<string> knownFakes = {
+            "48283 2:269 3:269 13:269 619:269", "50861 2:814 5:814 2543:814",
+            "53203 2:464 3:464 8867:464",       "53483 2:140 11:140 13:140 17:140",
+            "53669 2:348 13417:348",            "54433 2:665 3:665 7:665",
+            "54901 2:459 3:459 5:459 61:459",   "55261 2:505 3:505 5:505 307:505",
+            "55293 2:310 23:310 601:310",       "57307 2:589 3:589 9551:589",
+            "57319 2:99 3:99 41:99 233:99",     "57485 2:46 7:46 2053:46",
+        };
+        vector<PrimeCertificate> certs;
+        for (const string& line : knownFakes) {
+            PrimeCertificate cert;
+            parseCertificate(line, cert);
+            certs.push_back(cert);
+        }
+
+        // различные простые делители n-1 перебором
+        auto factorize = [](int n) {
+            vector<int> factors;
+            int rest = n - 1;
+            for (int d = 2; d <= rest / d; ++d) {
+                if (rest % d != 0) continue;
+                factors.push_back(d);
+                while (rest % d == 0) rest /= d;
+            }
+            if (rest > 1) factors.push_back(rest);
+            return factors;
+        };
+
+        SplitMix64 rng{seed + 10};
+        long long count = max(1LL, scale / 1000);
+        vector<int> numbers = {INT32_MAX}; // наибольшее простое в int
+        for (long long i = 0; i < 2 * count; ++i) {
+            // половина простых, половина нечетных составных
+            bool wantPrime = i % 2 == 0;
+            int n;
+            do {
+                n = rng.range(3, INT32_MAX) | 1;
+            } while (isSmallPrime(n) != wantPrime);
+            numbers.push_back(n);
+        }
+        for (int n : numbers) {
+            PrimeCertificate cert;
+            vector<int> factors = factorize(n);
+            if (isSmallPrime(n)) {
+                buildCertificate(n, factors, cert); // при неудаче сертификат пустой и будет отвергнут
+            } else {
+                cert.n = n;
+                for (int q : factors) cert.witnesses.push_back({q, static_cast<int>(rng.range(2, n - 1))});
+            }
+            certs.push_back(cert);
+        }
+
+        k.cpp.values = toStrings(measure(k.cpp, reps, [&]() {
+            vector<int> out(certs.size());
+            for (size_t i = 0; i < certs.size(); ++i) out[i] = verifyCertificate(certs[i]);
+            return out;
+        }));
+        for (const PrimeCertificate& cert : certs) {
+            k.reference.push_back(isSmallPrime(cert.n) ? "1" : "0");
+            k.inputs.push_back(formatCertificate(cert));
+        }
+        k.cpp.items = certs.size();
+        kernels.push_back(move(k));
+    }
+
+    return kernels;
+}
+
+// запускает rust-драйвер и читает его результаты по именам ядер
+bool runRust(const string& driver, uint64_t seed, long long scale, int reps, map<string, KernelRun>& runs) {
+    string command = "'" + driver + "' --seed " + to_string(seed) + " --scale " + to_string(scale) +
+                     " --reps " + to_string(reps);
+    FILE* pipe = popen(command.c_str(), "r");
+    if (pipe == nullptr) return false;
+
+    // строки могут быть длинными, поэтому читаем весь вывод целиком
+    string output;
+    char buffer[1 << 16];
+    size_t got;
+    while ((got = fread(buffer, 1, sizeof(buffer), pipe)) > 0) output.append(buffer, got);
+    if (pclose(pipe) != 0) return false;
+
+    istringstream in(output);
+    string header, values;
+    while (getline(in, header) && getline(in, values)) {
+        istringstream head(header);
+        string tag, name;
+        KernelRun run;
+        if (!(head >> tag >> name >> run.items >> run.nanos) || tag != "kernel") return false;
+        istringstream items(values);
+        for (string v; items >> v;) run.values.push_back(v);
+        runs[name] = move(run);
+    }
+    return !runs.empty();
+}
+
+// количество расхождений с ожидаемыми значениями и описание первого из них
+long long compareExact(const Kernel& k, const vector<string>& expected, const string& side, string& first) {
+    long long mismatches = 0;
+    size_t n = max(k.cpp.values.size(), expected.size());
+    for (size_t i = 0; i < n; ++i) {
+        string a = i < k.cpp.values.size() ? k.cpp.values[i] : "-";
+        string b = i < expected.size() ? expected[i] : "-";
+        if (a == b) continue;
+        if (mismatches++ == 0) {
+            first = "элемент " + to_string(i) + (i < k.inputs.size() ? " (" + k.inputs[i] + ")" : "") +
+                    ": c++ " + a + ", " + side + " " + b;
+        }
+    }
+    return mismatches;
+}
+
+// количество не простых чисел в результатах обеих версий
+long long comparePrimes(const Kernel& k, const KernelRun& rust, string& first) {
+    long long bad = 0;
+    auto checkAll = [&](const vector<string>& values, const string& side) {
+        for (const string& v : values) {
+            if (isSmallPrime(stoi(v))) continue;
+            if (bad++ == 0) first = side + " выдала составное число " + v;
+        }
+    };
+    checkAll(k.cpp.values, "c++");
+    checkAll(rust.values, "rust");
+    if (static_cast<long long>(k.cpp.values.size()) != k.cpp.items ||
+        static_cast<long long>(rust.values.size()) != rust.items) {
+        if (bad++ == 0) first = "количество чисел не совпадает с запрошенным";
+    }
+    return bad;
+}
+
+// дополняет текст пробелами до width символов (для utf-8 считаются символы, а не байты)
+string pad(const string& text, size_t width, bool left) {
+    size_t chars = count_if(text.begin(), text.end(), [](char c) { return (c & 0xC0) != 0x80; });
+    string spaces(width > chars ? width - chars : 0, ' ');
+    return left ? text + spaces : spaces + text;
+}
+
+string fixed1(double value) {
+    ostringstream out;
+    out << fixed << setprecision(1) << value;
+    return out.str();
+}
+
+int main(int argc, char* argv[]) {
+    string driver = "crosscheck-r/target/release/crosscheck-r";
+    uint64_t seed = 1;
+    long long scale = 100000;
+    int reps = 3;
+
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--rust" && hasValue) {
+            driver = argv[++i];
+        } else if (arg == "--seed" && hasValue) {
+            seed = stoull(argv[++i]);
+        } else if (arg == "--scale" && hasValue) {
+            scale = max(1000LL, stoll(argv[++i]));
+        } else if (arg == "--reps" && hasValue) {
+            reps = max(1, stoi(argv[++i]));
+        } else {
+            cout << "неизвестный параметр: " << arg << endl;
+            return 2;
+        }
+    }
+
+    map<string, KernelRun> rust;
+    if (!runRust(driver, seed, scale, reps, rust)) {
+        cout << "ошибка при запуске rust-драйвера " << driver << endl;
+        return 2;
+    }
+    vector<Kernel> kernels = runCpp(seed, scale, reps);
+
+    cout << pad("ядро", 22, true) << pad("входов", 10, false) << pad("расхождений", 13, false)
+         << pad("c++, тыс/с", 14, false) << pad("rust, тыс/с", 14, false) << pad("rust/c++", 10, false) << "\n";
+
+    long long total = 0;
+    vector<string> details;
+    for (const Kernel& k : kernels) {
+        double cppRate = k.cpp.items / k.cpp.nanos * 1e6;
+        if (k.check == Check::Local) {
+            string first;
+            long long bad = compareExact(k, k.reference, "эталон", first);
+            total += bad;
+            if (bad > 0) details.push_back(k.name + ": " + first);
+            cout << pad(k.name, 22, true) << pad(to_string(k.cpp.items), 10, false)
+                 << pad(to_string(bad), 13, false) << pad(fixed1(cppRate), 14, false)
+                 << pad("-", 14, false) << pad("-", 10, false) << "\n";
+            continue;
+        }
+
+        auto it = rust.find(k.name);
+        if (it == rust.end()) {
+            cout << pad(k.name, 22, true) << "  нет результатов rust-драйвера\n";
+            ++total;
+            continue;
+        }
+        const KernelRun& r = it->second;
+        string first;
+        long long bad = k.check == Check::Exact ? compareExact(k, r.values, "rust", first) : comparePrimes(k, r, first);
+        total += bad;
+        if (bad > 0) details.push_back(k.name + ": " + first);
+
+        double rustRate = r.items / r.nanos * 1e6;
+        cout << pad(k.name, 22, true) << pad(to_string(k.cpp.items), 10, false)
+             << pad(to_string(bad), 13, false) << pad(fixed1(cppRate), 14, false)
+             << pad(fixed1(rustRate), 14, false) << pad(fixed1(rustRate / cppRate), 10, false) << "\n";
+    }
+
+    for (const string& d : details) cout << d << "\n";
+    cout << (total == 0 ? "результаты совпадают" : "найдены расхождения") << endl;
+    return total == 0 ? 0 : 1;
+}
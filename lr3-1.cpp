@@ -2,44 +2,10 @@
 #include <cmath>
 #include <iomanip>
 
-using namespace std;
+#include "lr3lib.h"
 
-// функция для вычисления значения y в зависимости от x
-double calculateY(double x) {
-    // если x в диапазоне от -5 до -2 (включительно)
-    if (x >= -5 && x <= -2) {
-        // вычисляем y для прямой, проходящей через точки (-5,-1) и (-2,0)
-        // уравнение прямой: (y - y1)/(y2 - y1) = (x - x1)/(x2 - x1)
-        return (1.0 / 3.0) * (x + 5) - 1;
-    }
-    // если x в диапазоне от -2 до 0 (не включая 0)
-    else if (x > -2 && x < 0) {
-        // горизонтальная линия y=0
-        return 0.5 * (x + 2) - 1;
-    }
-    // если x в диапазоне от 0 до 2 (не включая 2)
-    else if (x >= 0 && x < 2) {
-        // вычисляем тангенс от x/2
-        return tan(x / 2.0);
-    }
-    // если x в диапазоне от 2 до 3 (не включая 3)
-    else if (x >= 2 && x < 3) {
-        // прямая, проходящая через точки (2,tan(1)) и (3,0)
-        // угловой коэффициент k = (0 - tan(1))/(3 - 2) = -tan(1)
-        return -tan(1.0) * (x - 2) + tan(1.0);
-    }
-    // если x в диапазоне от 3 до 5 (включительно)
-    else if (x >= 3 && x <= 5) {
-        // прямая, проходящая через точки (3,0) и (5,1)
-        // угловой коэффициент k = (1 - 0)/(5 - 3) = 0.5
-        return 0.5 * (x - 3);
-    }
-    // если x вне заданного диапазона
-    else {
-        // возвращаем "не число" (nan)
-        return NAN;
-    }
-}
+using namespace std;
+using namespace lr3;
 
 int main() {
     // объявление переменных для границ интервала и шага
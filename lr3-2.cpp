@@ -1,682 +1,384 @@
 #include <iostream>
 #include <vector>
-#include <tuple>
-#include <set>
-#include <cmath>
 #include <random>
-#include <algorithm>
-#include <iomanip>
 #include <string>
+#include <charconv>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <cstdint>
+#include <bit>
+#include <cstring>
+#include <csignal>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "lr3lib.h"
 
 using namespace std;
-
-// функция для быстрого возведения в степень по модулю
-// принимает основание, показатель степени и модуль
-// возвращает результат возведения в степень по модулю
-int modPow(int base, int exponent, int modulus) {
-    // инициализируем результат
-    int result = 1;
-    // берем основание по модулю, чтобы избежать переполнения
-    base %= modulus;
-    
-    // основной цикл возведения в степень
-    while (exponent > 0) {
-        // если показатель степени нечетный
-        if (exponent % 2 == 1) {
-            // умножаем результат на основание по модулю
-            result = (result * base) % modulus;
-        }
-        // делим показатель степени на 2
-        exponent >>= 1;
-        // возводим основание в квадрат по модулю
-        base = (base * base) % modulus;
+using namespace lr3;
+
+// проверка пакета сертификатов из stdin, по одному на строку
+// для каждого выводится "n +" если сертификат доказывает простоту, иначе "n -"
+int verifyCertificates() {
+    string line;
+    int passed = 0, total = 0;
+    while (getline(cin, line)) {
+        if (line.empty()) continue;
+        PrimeCertificate cert;
+        bool parsed = parseCertificate(line, cert);
+        bool ok = parsed && verifyCertificate(cert);
+        cout << (parsed ? to_string(cert.n) : line) << " " << (ok ? "+" : "-") << "\n";
+        passed += ok;
+        ++total;
     }
-    // возвращаем конечный результат
-    return result;
+    cout << "подтверждено: " << passed << " из " << total << "\n";
+    return passed == total ? 0 : 1;
 }
 
-// реализация решета эратосфена для нахождения всех простых чисел до n
-// возвращает вектор простых чисел
-vector<int> sieveOfEratosthenes(int n) {
-    // если n меньше 2, возвращаем пустой вектор
-    if (n < 2) return {};
-
-    // создаем вектор булевых значений, изначально все true
-    vector<bool> is_prime(n + 1, true);
-    is_prime[0] = is_prime[1] = false;
-
-    // основной цикл просеивания
-    for (int p = 2; p * p <= n; ++p) {
-        if (is_prime[p]) {
-            // отмечаем все кратные p числа как составные
-            for (int multiple = p * p; multiple <= n; multiple += p) {
-                is_prime[multiple] = false;
-            }
-        }
+// вывод результатов алгоритмов поклингтона и миллера
+// принимает название алгоритма и найденные числа
+void printResults(const string& title, const vector<GeneratedPrime>& found) {
+    // выводим заголовок
+    cout << "\nрезультаты генерации " << title << ":\n";
+    cout << "--------------------------------------------------\n";
+    cout << "номер\tпростое число\tтест\tпопыток\tсертификат\n";
+    cout << "--------------------------------------------------\n";
+
+    // выводим все найденные простые числа
+    for (size_t i = 0; i < found.size(); i++) {
+        const GeneratedPrime& p = found[i];
+        cout << i+1 << "\t" << p.prime << "\t" << (p.confirmed ? "+" : "-") << "\t" << p.attempts << "\t"
+             << (p.certified ? formatCertificate(p.certificate) : "-") << "\n";
     }
 
-    // собираем все простые числа в вектор
-    vector<int> primes;
-    for (int i = 2; i <= n; ++i) {
-        if (is_prime[i]) {
-            primes.push_back(i);
-        }
+    // выводим разделитель
+    cout << "--------------------------------------------------\n";
+}
+
+// вывод результатов алгоритма гост
+// принимает найденные простые числа и количество отвергнутых чисел
+void printResults(const vector<int>& primes, int rejected) {
+    // выводим заголовок
+    cout << "\nрезультаты генерации алгоритмом гост р 34.10-94:\n";
+    cout << "--------------------------------------------------\n";
+    cout << "номер\tпростое число\tтест\n";
+    cout << "--------------------------------------------------\n";
+
+    // выводим все найденные простые числа, каждое прошло тест
+    for (size_t i = 0; i < primes.size(); i++) {
+        cout << i+1 << "\t" << primes[i] << "\t" << "пройден" << "\n";
     }
 
-    return primes;
+    // выводим статистику
+    cout << "--------------------------------------------------\n";
+    cout << "всего отвергнуто чисел: " << rejected << "\n";
+    cout << "--------------------------------------------------\n";
 }
 
-// генерация случайного целого числа в диапазоне [min, max]
-int getRandomInt(int min, int max) {
-    // создаем устройство для получения случайных чисел
-    static random_device rd;
-    // инициализируем генератор случайных чисел
-    static mt19937 gen(rd());
-    // создаем равномерное распределение в заданном диапазоне
-    uniform_int_distribution<int> dist(min, max);
-    // возвращаем случайное число
-    return dist(gen);
+// ---- режим службы: простые числа по запросам через unix-сокет
+// запрос - 4 байта: алгоритм (1 - поклингтон, 2 - миллер, 3 - гост), битовая длина
+// выдаваемых чисел (старший единичный бит ровно в этой позиции),
+// количество чисел (uint16, little-endian). ответ: код (0 - успех, 1 - неверный запрос),
+// количество чисел (uint16) и сами числа (uint32), все в порядке little-endian.
+// в одном соединении можно отправить сколько угодно запросов подряд
+
+// допустимые битовые длины: генераторы кандидатов считают в int и проверены до 15 бит
+const int minDaemonBits = 6;
+const int maxDaemonBits = 15;
+
+// параметр генератора поклингтона, при котором он выдает числа длины bits:
+// кандидат n = R*f + 1, где 2^h < f < 2^(h+1), R - четное из [h, h+2], h = параметр / 2,
+// поэтому длина результата заметно меньше самого параметра
+int pocklingtonParam(int bits) {
+    for (int h = 1; ; ++h) {
+        int rMin = h % 2 == 0 ? h : h + 1;
+        int rMax = (h + 1) % 2 == 0 ? h + 1 : h + 2;
+        int lo = bit_width(static_cast<unsigned>(rMin * ((1 << h) + 1) + 1));
+        int hi = bit_width(static_cast<unsigned>(rMax * ((1 << (h + 1)) - 1) + 1));
+        if (lo <= bits && bits <= hi) return 2 * h;
+    }
 }
 
-// генерация случайного вещественного числа в диапазоне [0.0, 1.0)
-double getRandomDouble() {
-    // создаем устройство для получения случайных чисел
-    static random_device rd;
-    static mt19937 gen(rd());
-    uniform_real_distribution<double> dist(0.0, 1.0);
-    // возвращаем случайное число
-    return dist(gen);
+// генерирует одно простое число заданным алгоритмом с параметрами из меню.
+// поклингтон и гост выдают числа в пределах нескольких бит от параметра,
+// поэтому числа другой длины отбрасываются и генерация повторяется
+int generateOne(int algo, int bits, mt19937& gen) {
+    while (true) {
+        int p;
+        if (algo == 1 || algo == 2) {
+            vector<GeneratedPrime> found;
+            if (algo == 1) {
+                PocklingtonPrimality::generatePrimes(pocklingtonParam(bits), 10, 1, gen, found);
+            } else {
+                MillerPrimality::generatePrimes(bits, 5, 1, gen, found);
+            }
+            p = found[0].prime;
+        } else {
+            // для гост без требования уникальности, иначе при малой длине чисел может не хватить
+            p = GOSTPrimality::generatePrime(smallPrimes(), bits, gen);
+            if (!MillerPrimality::millerRabinTest(p, 3, gen)) continue;
+        }
+        if (static_cast<int>(bit_width(static_cast<unsigned>(p))) == bits) return p;
+    }
 }
 
-// класс для реализации алгоритма поклингтона
-class PocklingtonPrimality {
+// запас заранее сгенерированных простых чисел для каждого алгоритма и битовой длины.
+// фоновый поток пополняет запасы, опустившиеся ниже половины, до capacity чисел.
+// если запаса не хватает, недостающие числа генерирует поток, обслуживающий запрос
+class PrimePool {
 public:
-    // метод для проверки числа на простоту по тесту поклингтона
-    // принимает число для проверки, количество тестов и вектор множителей
-    // возвращает true, если число вероятно простое
-    static bool isPrime(int n, int tests, const vector<int>& factors) {
-        // множество для хранения уникальных баз
-        set<int> usedBases;
-
-        // генерируем необходимое количество уникальных баз
-        while (usedBases.size() != static_cast<size_t>(tests)) {
-            // получаем случайное основание
-            int base = getRandomInt(2, n - 1);
-            // добавляем в множество
-            usedBases.insert(base);
+    explicit PrimePool(size_t capacity)
+        : capacity(capacity), pools(3 * (maxDaemonBits + 1)), refiller(&PrimePool::refillLoop, this) {}
+
+    // выдает count чисел алгоритма algo длины bits в out
+    void take(int algo, int bits, size_t count, vector<int>& out, mt19937& gen) {
+        out.clear();
+        {
+            lock_guard<mutex> lock(guard);
+            deque<int>& pool = pools[index(algo, bits)];
+            size_t taken = min(count, pool.size());
+            out.assign(pool.begin(), pool.begin() + taken);
+            pool.erase(pool.begin(), pool.begin() + taken);
+            if (pool.size() < capacity / 2) wake.notify_one();
         }
-
-        // проверка первого условия теста поклингтона
-        for (int base : usedBases) {
-            // если a^(n-1) не сравнимо с 1 по модулю n
-            if (modPow(base, n - 1, n) != 1) {
-                // число составное
-                return false;
-            }
+        while (out.size() < count) {
+            out.push_back(generateOne(algo, bits, gen));
         }
-
-        // проверка второго условия теста поклингтона
-        for (int base : usedBases) {
-            // флаг, что число составное
-            bool isComposite = true;
-            // проверяем для каждого множителя
-            for (int factor : factors) {
-                // если a^((n-1)/q) сравнимо с 1 по модулю n
-                if (modPow(base, (n - 1) / factor, n) == 1) {
-                    // число может быть простым
-                    isComposite = false;
-                    break;
-                }
-            }
-            // если для всех множителей условие выполнено
-            if (isComposite) {
-                // число вероятно простое
-                return true;
-            }
-        }
-
-        // если не нашли подходящего основания, число составное
-        return false;
     }
 
-    // генерация кандидата на простое число и его множителей
-    // принимает вектор простых чисел и битовую длину
-    // возвращает кортеж из кандидата и вектора множителей
-    static tuple<int, vector<int>> generateCandidate(const vector<int>& primes, int bits) {
-        // максимальный индекс в векторе простых чисел
-        int maxIndex = primes.size() - 1;
-        // минимальное значение для R
-        int min = bits / 2 + 1;
-        // максимальное значение для R
-        int max = bits / 2 + 2;
-        // 2 в степени max
-        int powMax = pow(2, max);
-
-        // вычисляем максимальную степень для множителей
-        int maxPow = 1;
-        while (pow(2, maxPow) < pow(2, (bits / 2) + 1)) {
-            maxPow++;
-        }
-
-        // инициализация множителя f
-        int f = 1;
-        // вектор для хранения множителей
-        vector<int> factorList;
+private:
+    static size_t index(int algo, int bits) {
+        return (algo - 1) * (maxDaemonBits + 1) + bits;
+    }
 
-        // генерация множителей f
+    // фоновое пополнение: по одному числу за раз, блокировка не держится во время генерации
+    void refillLoop() {
+        // пониженный приоритет, чтобы пополнение не отнимало процессор у запросов
+        setpriority(PRIO_PROCESS, gettid(), 10);
+        mt19937 gen(random_device{}());
+        unique_lock<mutex> lock(guard);
         while (true) {
-            // выбираем случайный индекс простого числа
-            int randIdx = getRandomInt(0, maxIndex);
-            // выбираем случайную степень
-            int randPow = getRandomInt(1, maxPow);
-
-            // проверяем, что произведение не превышает powMax
-            if (f * pow(primes[randIdx], randPow) < powMax) {
-                // умножаем f на простое число в степени
-                f *= pow(primes[randIdx], randPow);
-                // добавляем простое число в список множителей
-                factorList.push_back(primes[randIdx]);
-            }
-
-            // если f вышло за границы
-            if (f > pow(2, (bits / 2))) {
-                // если f слишком большое, начинаем заново
-                if (f >= pow(2, (bits / 2) + 1)) {
-                    f = 1;
-                    factorList.clear();
-                } else {
-                    // иначе завершаем генерацию
-                    break;
+            // ищем самый опустевший запас
+            size_t best = 0, bestSize = capacity;
+            int bestAlgo = 0, bestBits = 0;
+            for (int algo = 1; algo <= 3; ++algo) {
+                for (int bits = minDaemonBits; bits <= maxDaemonBits; ++bits) {
+                    size_t size = pools[index(algo, bits)].size();
+                    if (size < bestSize) {
+                        best = index(algo, bits);
+                        bestSize = size;
+                        bestAlgo = algo;
+                        bestBits = bits;
+                    }
                 }
             }
-        }
-
-        // генерируем случайное R
-        int R = getRandomInt(min - 1, max - 1);
-        // делаем R четным
-        if (R % 2 != 0) R++;
-        // вычисляем кандидата n = R*f + 1
-        int candidate = R * f + 1;
-        // возвращаем кандидата и множители
-        return make_tuple(candidate, factorList);
-    }
-
-    // метод для генерации простых чисел алгоритмом поклингтона
-    // принимает битовую длину, количество тестов и количество чисел для генерации
-    static void generatePrimes(int bits, int tests, int count) {
-        // получаем список простых чисел до 500
-        vector<int> primes = sieveOfEratosthenes(500);
-        // вектор для хранения найденных простых чисел
-        vector<int> candidates;
-        // вектор для хранения результатов тестов
-        vector<string> testResults;
-        // вектор для хранения количества попыток
-        vector<int> attempts;
-        // счетчик текущих попыток
-        int currentAttempts = 0;
-
-        // генерируем указанное количество простых чисел
-        while (candidates.size() < static_cast<size_t>(count)) {
-            // генерируем кандидата и его множители
-            int n;
-            vector<int> factors;
-            tie(n, factors) = generateCandidate(primes, bits);
-
-            // проверяем кандидата на простоту
-            if (isPrime(n, tests, factors)) {
-                // если число прошло тест, добавляем в результат
-                candidates.push_back(n);
-                // дополнительная проверка тестом миллера-рабина
-                testResults.push_back(millerRabinTest(n, 3) ? "+" : "-");
-                // сохраняем количество попыток
-                attempts.push_back(currentAttempts);
-                // сбрасываем счетчик попыток
-                currentAttempts = 0;
-            } else {
-                // если число не прошло тест
-                if (millerRabinTest(n, 1)) {
-                    // увеличиваем счетчик попыток
-                    currentAttempts++;
-                }
+            if (bestAlgo == 0) {
+                // все запасы полны, ждем, пока какой-нибудь опустеет наполовину
+                wake.wait(lock);
+                continue;
             }
-        }
 
-        // выводим результаты
-        printResults(candidates, testResults, attempts);
+            lock.unlock();
+            int p = generateOne(bestAlgo, bestBits, gen);
+            lock.lock();
+            pools[best].push_back(p);
+        }
     }
 
-private:
-    // вспомогательный метод для теста миллера-рабина
-    // принимает число для проверки и количество тестов
-    // возвращает true, если число вероятно простое
-    static bool millerRabinTest(int num, int tests) {
-        // обработка тривиальных случаев
-        if (num == 2 || num == 3) return true;
-        if (num < 2 || num % 2 == 0) return false;
-
-        // раскладываем num-1 на d * 2^s
-        int d = num - 1;
-        int s = 0;
-        while (d % 2 == 0) {
-            d /= 2;
-            s++;
-        }
+    size_t capacity;
+    mutex guard;
+    condition_variable wake;
+    vector<deque<int>> pools; // запасы по index(algo, bits)
+    thread refiller;          // объявлен последним, чтобы стартовать после остальных полей
+};
 
-        // проводим указанное количество тестов
-        for (int i = 0; i < tests; i++) {
-            // выбираем случайное основание
-            int a = getRandomInt(2, num - 2);
-            // вычисляем x = a^d mod num
-            int x = modPow(a, d, num);
-            int y;
-            
-            // проводим s итераций
-            for (int j = 0; j < s; j++) {
-                // вычисляем y = x^2 mod num
-                y = modPow(x, 2, num);
-                // проверяем условия
-                if (y == 1 && x != 1 && x != (num - 1)) {
-                    // число составное
-                    return false;
-                }
-                x = y;
-            }
-            // проверяем окончательное условие
-            if (y != 1) {
-                // число составное
-                return false;
-            }
-        }
-        // если все тесты пройдены, число вероятно простое
-        return true;
+// читает или пишет ровно size байт, false при ошибке или закрытии соединения
+bool readFull(int fd, void* data, size_t size) {
+    char* bytes = static_cast<char*>(data);
+    while (size > 0) {
+        ssize_t got = read(fd, bytes, size);
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) return false;
+        bytes += got;
+        size -= got;
     }
+    return true;
+}
 
-    // метод для вывода результатов
-    // принимает векторы найденных чисел, результатов тестов и количества попыток
-    static void printResults(const vector<int>& primes, 
-                           const vector<string>& tests, 
-                           const vector<int>& attempts) {
-        // выводим заголовок
-        cout << "\nрезультаты генерации алгоритмом поклингтона:\n";
-        cout << "--------------------------------------------------\n";
-        cout << "номер\tпростое число\tтест\tпопыток\n";
-        cout << "--------------------------------------------------\n";
-
-        // выводим все найденные простые числа
-        for (size_t i = 0; i < primes.size(); i++) {
-            cout << i+1 << "\t" << primes[i] << "\t" << tests[i] << "\t" << attempts[i] << "\n";
-        }
-
-        // выводим разделитель
-        cout << "--------------------------------------------------\n";
+bool writeFull(int fd, const void* data, size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t sent = write(fd, bytes, size);
+        if (sent < 0 && errno == EINTR) continue;
+        if (sent <= 0) return false;
+        bytes += sent;
+        size -= sent;
     }
-};
+    return true;
+}
 
-// класс для реализации алгоритма миллера
-class MillerPrimality {
-public:
-    // метод для проверки числа на простоту по тесту миллера
-    // принимает кандидата, количество тестов и вектор множителей
-    // возвращает true, если число вероятно простое
-    static bool isPrime(int candidate, int testCount, const vector<int>& factors) {
-        // множество для хранения уникальных баз
-        set<int> bases;
-
-        // генерируем необходимое количество уникальных баз
-        while (bases.size() < static_cast<size_t>(testCount)) {
-            // получаем случайное основание
-            int base = getRandomInt(2, candidate - 2);
-            // добавляем в множество
-            bases.insert(base);
+// обслуживает одно соединение до его закрытия
+void serveClient(int fd, PrimePool& pool) {
+    mt19937 gen(random_device{}());
+    vector<int> primes;
+    vector<unsigned char> response;
+    unsigned char request[4];
+    while (readFull(fd, request, sizeof(request))) {
+        int algo = request[0], bits = request[1];
+        size_t count = request[2] | (request[3] << 8);
+        bool valid = algo >= 1 && algo <= 3 && bits >= minDaemonBits && bits <= maxDaemonBits;
+        if (valid) {
+            pool.take(algo, bits, count, primes, gen);
+        } else {
+            primes.clear();
         }
 
-        // проверка первого условия теста миллера
-        for (int base : bases) {
-            // если a^(n-1) не сравнимо с 1 по модулю n
-            if (modPow(base, candidate - 1, candidate) != 1) {
-                // число составное
-                return false;
-            }
+        response.assign(3 + 4 * primes.size(), 0);
+        response[0] = valid ? 0 : 1;
+        response[1] = primes.size() & 0xFF;
+        response[2] = primes.size() >> 8;
+        for (size_t i = 0; i < primes.size(); ++i) {
+            uint32_t p = primes[i];
+            for (int b = 0; b < 4; ++b) response[3 + 4 * i + b] = (p >> (8 * b)) & 0xFF;
         }
-
-        // проверка второго условия теста миллера
-        for (int factor : factors) {
-            // флаг, что все основания дали 1
-            bool allOnes = true;
-            // проверяем для каждого основания
-            for (int base : bases) {
-                // вычисляем показатель степени
-                int exponent = (candidate - 1) / factor;
-                // если a^((n-1)/q) не сравнимо с 1 по модулю n
-                if (modPow(base, exponent, candidate) != 1) {
-                    // не все основания дали 1
-                    allOnes = false;
-                    break;
-                }
-            }
-            // если для какого-то множителя все основания дали 1
-            if (allOnes) {
-                // число составное
-                return false;
-            }
-        }
-
-        // если все условия выполнены, число вероятно простое
-        return true;
+        if (!writeFull(fd, response.data(), response.size())) break;
     }
+    close(fd);
+}
 
-    // генерация кандидата на простое число и его множителей
-    // принимает вектор простых чисел и битовую длину
-    // возвращает пару из кандидата и вектора множителей
-    static pair<int, vector<int>> generateCandidate(const vector<int>& primes, int bitLength) {
-        // нижняя граница для m
-        const int lowerBound = pow(2, bitLength - 2);
-        // верхняя граница для m
-        const int upperBound = pow(2, bitLength - 1) - 1;
-        
-        // инициализация m
-        int m = 1;
-        // вектор для хранения множителей
-        vector<int> factors;
-
-        // генерация множителей m
-        while (true) {
-            // выбираем случайный индекс простого числа
-            int randomIndex = getRandomInt(0, primes.size() - 1);
-            // получаем простое число по индексу
-            int randomPrime = primes[randomIndex];
-            
-            // проверяем, не превысили ли верхнюю границу
-            if (m * randomPrime > upperBound) {
-                // если достигли нижней границы, завершаем
-                if (m >= lowerBound) break;
-                // иначе начинаем заново
-                m = 1;
-                factors.clear();
-                continue;
-            }
-            
-            // умножаем m на простое число
-            m *= randomPrime;
-            // добавляем простое число в множители
-            factors.push_back(randomPrime);
-        }
+// заполняет адрес unix-сокета, false если путь слишком длинный
+bool socketAddress(const string& path, sockaddr_un& addr) {
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path)) return false;
+    memcpy(addr.sun_path, path.c_str(), path.size());
+    return true;
+}
 
-        // возвращаем кандидата n = 2*m + 1 и множители
-        return {2 * m + 1, factors};
-    }
+// режим службы: слушает сокет path, каждое соединение обслуживается в своем потоке
+int runDaemon(const string& path) {
+    // запись в закрытое клиентом соединение не должна завершать службу
+    signal(SIGPIPE, SIG_IGN);
 
-    // метод для генерации простых чисел алгоритмом миллера
-    // принимает битовую длину, количество тестов и количество чисел для генерации
-    static void generatePrimes(int bitLength, int testCount, int targetCount) {
-        // получаем список простых чисел до 500
-        auto smallPrimes = sieveOfEratosthenes(500);
-        // вектор для хранения найденных простых чисел
-        vector<int> primesFound;
-        // вектор для хранения результатов тестов
-        vector<string> testResults;
-        // вектор для хранения количества попыток
-        vector<int> attemptsCount;
-        // счетчик текущих попыток
-        int attempts = 0;
-
-        // генерируем указанное количество простых чисел
-        while (primesFound.size() < static_cast<size_t>(targetCount)) {
-            // генерируем кандидата и его множители
-            auto [candidate, factors] = generateCandidate(smallPrimes, bitLength);
-            
-            // проверяем кандидата на простоту
-            if (isPrime(candidate, testCount, factors)) {
-                // если число прошло тест, добавляем в результат
-                primesFound.push_back(candidate);
-                // дополнительная проверка тестом миллера-рабина
-                testResults.push_back(millerRabinTest(candidate, 3) ? "+" : "-");
-                // сохраняем количество попыток
-                attemptsCount.push_back(attempts);
-                // сбрасываем счетчик попыток
-                attempts = 0;
-            } else {
-                // если число не прошло тест
-                if (millerRabinTest(candidate, 1)) {
-                    // увеличиваем счетчик попыток
-                    ++attempts;
-                }
-            }
-        }
-
-        // выводим результаты
-        printResults(primesFound, testResults, attemptsCount);
+    sockaddr_un addr;
+    if (!socketAddress(path, addr)) {
+        cout << "слишком длинный путь к сокету" << endl;
+        return 1;
     }
-
-private:
-    // вспомогательный метод для теста миллера-рабина
-    // принимает число для проверки и количество тестов
-    // возвращает true, если число вероятно простое
-    static bool millerRabinTest(int num, int count) {
-        // обработка тривиальных случаев
-        if (num == 2 || num == 3) return true;
-        if (num % 2 == 0 || num < 2) return false;
-
-        // раскладываем num-1 на d * 2^s
-        int d = num - 1;
-        int s = 0;
-        while (d % 2 == 0) {
-            d /= 2;
-            ++s;
-        }
-
-        // проводим указанное количество тестов
-        for (int i = 0; i < count; ++i) {
-            // выбираем случайное основание
-            int a = getRandomInt(2, num - 2);
-            // вычисляем x = a^d mod num
-            int x = modPow(a, d, num);
-            
-            // если x равно 1 или num-1, переходим к следующему тесту
-            if (x == 1 || x == num - 1) continue;
-            
-            // флаг, что число составное
-            bool composite = true;
-            // проводим s-1 итераций
-            for (int j = 0; j < s - 1; ++j) {
-                // вычисляем x = x^2 mod num
-                x = modPow(x, 2, num);
-                // если x равно num-1, число вероятно простое
-                if (x == num - 1) {
-                    composite = false;
-                    break;
-                }
-            }
-            
-            // если составное, возвращаем false
-            if (composite) return false;
+    // удаляется только сокет от прошлого запуска, любой другой файл по этому пути остается
+    struct stat existing;
+    if (lstat(path.c_str(), &existing) == 0) {
+        if (!S_ISSOCK(existing.st_mode)) {
+            cout << "путь " << path << " занят файлом, который не является сокетом" << endl;
+            return 1;
         }
-        
-        // если все тесты пройдены, число вероятно простое
-        return true;
+        unlink(path.c_str());
+    } else if (errno != ENOENT) {
+        cout << "ошибка при проверке пути к сокету: " << strerror(errno) << endl;
+        return 1;
+    }
+    int server = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (server < 0 || bind(server, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        listen(server, 64) < 0) {
+        cout << "ошибка при создании сокета: " << strerror(errno) << endl;
+        return 1;
     }
 
-    // метод для вывода результатов
-    // принимает векторы найденных чисел, результатов тестов и количества попыток
-    static void printResults(const vector<int>& primes, 
-                           const vector<string>& tests, 
-                           const vector<int>& attempts) {
-        // выводим заголовок
-        cout << "\nрезультаты генерации алгоритмом миллера:\n";
-        cout << "--------------------------------------------------\n";
-        cout << "номер\tпростое число\tтест\tпопыток\n";
-        cout << "--------------------------------------------------\n";
-
-        // выводим все найденные простые числа
-        for (size_t i = 0; i < primes.size(); i++) {
-            cout << i+1 << "\t" << primes[i] << "\t" << tests[i] << "\t" << attempts[i] << "\n";
+    // таблица малых простых строится до первого запроса
+    smallPrimes();
+    PrimePool pool(1024);
+    cout << "служба запущена: " << path << endl;
+
+    while (true) {
+        int client = accept(server, nullptr, nullptr);
+        if (client < 0) {
+            if (errno == EINTR) continue;
+            cout << "ошибка при подключении клиента: " << strerror(errno) << endl;
+            continue;
         }
-
-        // выводим разделитель
-        cout << "--------------------------------------------------\n";
+        thread(serveClient, client, ref(pool)).detach();
     }
-};
+}
 
-// класс для реализации алгоритма гост р 34.10-94
-class GOSTPrimality {
-public:
-    // метод для генерации простого числа по гост
-    // принимает вектор простых чисел и битовую длину
-    // возвращает простое число
-    static int generatePrime(const vector<int>& primes, int bitLen) {
-        // вычисляем длину q в битах
-        int qBitLen = (bitLen + 1) / 2;
-        // минимальное значение для q
-        int qMin = 0;
-        // максимальное значение для q
-        int qMax = (1 << qBitLen) - 1;
-
-        // переменная для хранения q
-        int q;
-        // выбираем простое число q подходящего размера
-        do {
-            q = primes[getRandomInt(0, primes.size() - 1)];
-        } while (q < qMin || q > qMax);
-
-        // основной цикл генерации простого числа p
-        while (true) {
-            // генерируем случайное число ξ в диапазоне [0, 1)
-            double ξ = getRandomDouble();
-            // вычисляем n по формуле
-            double n = (double(1 << (bitLen - 1)) + (ξ * double(1 << (bitLen - 1)))) / q;
-            // преобразуем n в целое число
-            int nInt = int(n);
-            // если nInt нечетное, делаем его четным
-            if (nInt % 2 != 0) nInt++;
-
-            // поиск подходящего p = (nInt + k)*q + 1
-            for (int k = 0; ; k += 2) {
-                // вычисляем кандидата p
-                int p = (nInt + k) * q + 1;
-                // если p превысило максимальное значение, выходим из цикла
-                if (p > (1 << bitLen)) break;
-
-                // проверка условий простоты
-                if (modPow(2, p - 1, p) == 1 && modPow(2, nInt + k, p) != 1) {
-                    // если условия выполнены, возвращаем p
-                    return p;
-                }
-            }
-        }
+// клиент службы: один запрос, числа выводятся по одному на строку
+int runQuery(const string& path, int algo, int bits, int count) {
+    sockaddr_un addr;
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || !socketAddress(path, addr) ||
+        connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        cout << "ошибка при подключении к службе" << endl;
+        return 1;
     }
 
-    // метод для генерации простых чисел по гост
-    // принимает битовую длину, количество тестов и количество чисел для генерации
-    static void generatePrimes(int bitLength, int testRounds, int targetCount) {
-        // множество для хранения уникальных простых чисел
-        set<int> primesSet;
-        // получаем список простых чисел до 500
-        vector<int> primes = sieveOfEratosthenes(500);
-        // вектор для хранения результатов тестов
-        vector<string> testResults;
-        // счетчик отвергнутых чисел
-        int rejected = 0;
-
-        // выводим сообщение о начале генерации
-        cout << "начало генерации простых чисел по гост...\n";
-        cout << "это может занять некоторое время...\n";
-
-        // генерируем указанное количество уникальных простых чисел
-        while (primesSet.size() < static_cast<size_t>(targetCount)) {
-            // генерируем кандидата p
-            int p = generatePrime(primes, bitLength);
-            // если число уже есть в множестве, пропускаем его
-            if (primesSet.count(p)) continue;
-
-            // проверяем кандидата тестом миллера-рабина
-            if (millerRabinTest(p, testRounds)) {
-                // если тест пройден, добавляем число в множество
-                primesSet.insert(p);
-                testResults.push_back("пройден");
-                // выводим прогресс
-                cout << "найдено простых чисел: " << primesSet.size() << " из " << targetCount << "\n";
-            } else {
-                // увеличиваем счетчик отвергнутых чисел
-                rejected++;
-            }
-        }
+    unsigned char request[4] = {static_cast<unsigned char>(algo), static_cast<unsigned char>(bits),
+                                static_cast<unsigned char>(count & 0xFF),
+                                static_cast<unsigned char>((count >> 8) & 0xFF)};
+    unsigned char header[3];
+    if (!writeFull(fd, request, sizeof(request)) || !readFull(fd, header, sizeof(header))) {
+        cout << "ошибка обмена со службой" << endl;
+        close(fd);
+        return 1;
+    }
+    if (header[0] != 0) {
+        cout << "служба отклонила запрос" << endl;
+        close(fd);
+        return 1;
+    }
 
-        // выводим результаты
-        printResults(primesSet, testResults, rejected);
+    size_t received = header[1] | (header[2] << 8);
+    vector<unsigned char> data(4 * received);
+    bool ok = readFull(fd, data.data(), data.size());
+    close(fd);
+    if (!ok) {
+        cout << "ошибка обмена со службой" << endl;
+        return 1;
+    }
+    for (size_t i = 0; i < received; ++i) {
+        uint32_t p = 0;
+        for (int b = 0; b < 4; ++b) p |= uint32_t(data[4 * i + b]) << (8 * b);
+        cout << p << "\n";
     }
+    return 0;
+}
 
-private:
-    // вспомогательный метод для теста миллера-рабина
-    // принимает число для проверки и количество тестов
-    // возвращает true, если число вероятно простое
-    static bool millerRabinTest(int num, int tests) {
-        // обработка тривиальных случаев
-        if (num == 2 || num == 3) return true;
-        if (num < 2 || num % 2 == 0) return false;
-
-        // раскладываем num-1 на d * 2^s
-        int d = num - 1;
-        int s = 0;
-        while (d % 2 == 0) {
-            d /= 2;
-            s++;
-        }
+// разбирает целое число из аргумента командной строки целиком, без исключений
+bool parseNumber(const char* text, int& value) {
+    const char* end = text + strlen(text);
+    auto [ptr, ec] = from_chars(text, end, value);
+    return ec == errc() && ptr == end && ptr != text;
+}
 
-        // проводим указанное количество тестов
-        for (int i = 0; i < tests; i++) {
-            // выбираем случайное основание
-            int a = getRandomInt(2, num - 2);
-            // вычисляем x = a^d mod num
-            int x = modPow(a, d, num);
-            int y;
-            
-            // проводим s итераций
-            for (int j = 0; j < s; j++) {
-                // вычисляем y = x^2 mod num
-                y = modPow(x, 2, num);
-                // проверяем условия
-                if (y == 1 && x != 1 && x != (num - 1)) {
-                    // число составное
-                    return false;
-                }
-                x = y;
-            }
-            // проверяем окончательное условие
-            if (y != 1) {
-                // число составное
-                return false;
-            }
-        }
-        // если все тесты пройдены, число вероятно простое
-        return true;
+// главная функция программы
+int main(int argc, char* argv[]) {
+    // с ключом --verify проверяются сертификаты из stdin
+    if (argc > 1 && string(argv[1]) == "--verify") {
+        return verifyCertificates();
     }
-
-    // метод для вывода результатов
-    // принимает множество простых чисел, результаты тестов и количество отвергнутых чисел
-    static void printResults(const set<int>& primes, 
-                           const vector<string>& tests, 
-                           int rejected) {
-        // выводим заголовок
-        cout << "\nрезультаты генерации алгоритмом гост р 34.10-94:\n";
-        cout << "--------------------------------------------------\n";
-        cout << "номер\tпростое число\tтест\n";
-        cout << "--------------------------------------------------\n";
-
-        // выводим все найденные простые числа
-        int i = 1;
-        for (int p : primes) {
-            cout << i++ << "\t" << p << "\t" << tests[i-2] << "\n";
+    // --daemon сокет запускает службу, --query сокет алгоритм биты количество - запрос к ней
+    if (argc > 2 && string(argv[1]) == "--daemon") {
+        return runDaemon(argv[2]);
+    }
+    if (argc > 5 && string(argv[1]) == "--query") {
+        // поля запроса - байты и uint16, поэтому значения проверяются до отправки,
+        // иначе они молча обрезались бы до другого запроса
+        int algo, bits, count;
+        if (!parseNumber(argv[3], algo) || !parseNumber(argv[4], bits) || !parseNumber(argv[5], count) ||
+            algo < 1 || algo > 3 || bits < minDaemonBits || bits > maxDaemonBits || count < 0 || count > 65535) {
+            cout << "некорректный запрос: алгоритм от 1 до 3, длина от " << minDaemonBits << " до "
+                 << maxDaemonBits << " бит, количество от 0 до 65535" << endl;
+            return 1;
         }
-
-        // выводим статистику
-        cout << "--------------------------------------------------\n";
-        cout << "всего отвергнуто чисел: " << rejected << "\n";
-        cout << "--------------------------------------------------\n";
+        return runQuery(argv[2], algo, bits, count);
     }
-};
 
-// главная функция программы
-int main() {
+    // генератор случайных чисел для всех алгоритмов
+    mt19937 gen(random_device{}());
+
     // выводим приветственное сообщение
     cout << "генерация простых чисел различными алгоритмами\n";
     cout << "--------------------------------------------------\n\n";
@@ -700,20 +402,31 @@ int main() {
             case 1: {
                 // генерация чисел алгоритмом поклингтона
                 cout << "\nгенерация простых чисел алгоритмом поклингтона\n";
-                PocklingtonPrimality::generatePrimes(13, 10, 10);
+                vector<GeneratedPrime> found;
+                PocklingtonPrimality::generatePrimes(13, 10, 10, gen, found);
+                printResults("алгоритмом поклингтона", found);
                 break;
             }
             case 2: {
                 // генерация чисел алгоритмом миллера
                 cout << "\nгенерация простых чисел алгоритмом миллера\n";
-                MillerPrimality::generatePrimes(10, 5, 10);
+                vector<GeneratedPrime> found;
+                MillerPrimality::generatePrimes(10, 5, 10, gen, found);
+                printResults("алгоритмом миллера", found);
                 break;
             }
             case 3: {
                 // генерация чисел алгоритмом гост
                 cout << "\nгенерация простых чисел алгоритмом гост р 34.10-94\n";
+                cout << "начало генерации простых чисел по гост...\n";
+                cout << "это может занять некоторое время...\n";
                 // уменьшаем параметры для ускорения работы
-                GOSTPrimality::generatePrimes(10, 3, 5);
+                vector<int> primes;
+                int rejected = GOSTPrimality::generatePrimes(10, 3, 5, gen, primes, [](size_t found, size_t target) {
+                    // выводим прогресс
+                    cout << "найдено простых чисел: " << found << " из " << target << "\n";
+                });
+                printResults(primes, rejected);
                 break;
             }
             case 0: {
@@ -730,4 +443,4 @@ int main() {
     } while (choice != 0);
 
     return 0;
-}
\ No newline at end of file
+}
@@ -1,54 +1,66 @@
 #include <iostream>
 #include <vector>
-#include <numeric>
+#include <map>
+#include <string>
 
-using namespace std; 
+#include "lr3lib.h"
 
-// функция для нахождения наибольшего общего делителя двух чисел
-int findGCD(int firstNum, int secondNum) {
-    while (secondNum != 0) { // пока второе число не ноль
-        int temp = secondNum; // сохраняем второе число
-        secondNum = firstNum % secondNum; // находим остаток от деления
-        firstNum = temp; // меняем первое число на бывшее второе
-    }
-    return firstNum; // возвращаем НОД
-}
+using namespace std; 
+using namespace lr3;
 
-// функция для вычисления суммы ряда
-pair<int, int> computeSeriesSum(int power, int base) {
-    // если степень равна 0, это базовый случай
-    if (power == 0) {
-        return {1, base - 1}; // возвращаем 1/(b-1)
-    }
+// таблица сумм ряда для одного основания
+struct SeriesTable {
+    int built = -1;                 // до какой степени таблица уже строилась
+    vector<pair<int, int>> sums;    // только суммы, посчитанные без переполнения
+};
 
-    // вычисляем сумму предыдущих членов
-    int totalNumerator = 0; // общий числитель
-    int totalDenominator = 1; // общий знаменатель
+// пакетный режим: читает пары "a b" до конца ввода и сразу выводит "a b результат"
+// таблица для каждого основания достраивается только до наибольшей запрошенной степени,
+// поэтому время зависит от количества различных оснований, а не от количества запросов
+int runBatch() {
+    // максимальная степень по условию задачи
+    const int maxPower = 10;
+    // кэш таблиц по основанию
+    map<int, SeriesTable> tables;
 
-    // суммируем все члены от 0 до power-1
-    for (int currentPower = 0; currentPower < power; currentPower++) {
-        auto [currentNum, currentDen] = computeSeriesSum(currentPower, base); // получаем текущий член
-        // (a/b + c/d = (ad + cb)/(b*d))
-        // приводим к общему знаменателю
-        int newNum = totalNumerator * currentDen + currentNum * totalDenominator;
-        int newDen = totalDenominator * currentDen;
+    int inputA, inputB;
+    while (cin >> inputA >> inputB) {
+        cout << inputA << " " << inputB << " ";
+        if (inputA < 1 || inputA > maxPower || inputB < 1 || inputB > 10) {
+            cout << "error\n"; // запрос вне допустимого диапазона
+            continue;
+        }
+        if (inputB == 1) {
+            cout << "infinity\n"; // ряд расходится
+            continue;
+        }
 
-        // сокращаем дробь
-        int gcdValue = findGCD(newNum, newDen);
-        totalNumerator = newNum / gcdValue;
-        totalDenominator = newDen / gcdValue;
+        // достраиваем таблицу, если запрошена степень больше прежних
+        SeriesTable& table = tables[inputB];
+        if (inputA > table.built) {
+            table.sums.resize(inputA + 1);
+            int valid = buildSeriesTable(inputA, inputB, table.sums.data());
+            table.sums.resize(valid + 1);
+            table.built = inputA;
+        }
+        if (inputA >= static_cast<int>(table.sums.size())) {
+            cout << "overflow\n"; // числитель или знаменатель не помещается в int
+            continue;
+        }
+        auto [resultNum, resultDen] = table.sums[inputA];
+        cout << resultNum << "/" << resultDen << "\n";
     }
 
-    // применяем итоговую формулу
-    int finalNum = base * totalNumerator;
-    int finalDen = (base - 1) * totalDenominator;
-
-    // сокращаем итоговую дробь
-    int finalGCD = findGCD(finalNum, finalDen);
-    return {finalNum / finalGCD, finalDen / finalGCD};
+    return 0;
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+    // запуск с ключом --batch включает пакетный режим без подсказок
+    if (argc > 1 && string(argv[1]) == "--batch") {
+        ios::sync_with_stdio(false);
+        return runBatch();
+    }
+
     cout << "введите два числа (от 1 до 10): "; // просим ввести числа
     int inputA, inputB;
     cin >> inputA >> inputB; // считываем ввод
@@ -65,8 +77,13 @@ int main() {
         return 0; // нормальное завершение
     }
 
-    // вычисляем сумму ряда
-    auto [resultNum, resultDen] = computeSeriesSum(inputA, inputB); // получаем результат
+    // вычисляем сумму ряда, с проверкой переполнения int
+    vector<pair<int, int>> sums(inputA + 1);
+    if (buildSeriesTable(inputA, inputB, sums.data()) < inputA) {
+        cout << "ошибка: сумма ряда не помещается в int\n";
+        return 1;
+    }
+    auto [resultNum, resultDen] = sums[inputA]; // получаем результат
 
     // выводим результат в виде дроби
     cout << resultNum << "/" << resultDen << "\n";
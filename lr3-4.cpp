@@ -1,62 +1,364 @@
 #include <iostream>
 #include <vector>
+#include <string>
+#include <charconv>
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+#include <climits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "lr3lib.h"
+
 using namespace std;
+using namespace lr3;
+
+// быстрое чтение целых чисел без потоков ввода-вывода
+// файл отображается в память целиком, stdin читается большими блоками,
+// числа разбираются через from_chars прямо из буфера
+class FastReader {
+public:
+    // path == nullptr означает чтение из stdin
+    explicit FastReader(const char* path) {
+        if (path == nullptr) {
+            fd = STDIN_FILENO;
+            buffer.resize(blockSize);
+            cur = end = buffer.data();
+            return;
+        }
+
+        fd = open(path, O_RDONLY);
+        struct stat info;
+        if (fd < 0 || fstat(fd, &info) != 0) {
+            failed = true;
+            eof = true;
+            return;
+        }
+        mappedSize = info.st_size;
+        eof = true; // весь файл сразу доступен, дочитывать нечего
+        if (mappedSize == 0) return;
+
+        void* data = mmap(nullptr, mappedSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            failed = true;
+            mappedSize = 0;
+            return;
+        }
+        madvise(data, mappedSize, MADV_SEQUENTIAL);
+        mapped = static_cast<const char*>(data);
+        cur = mapped;
+        end = mapped + mappedSize;
+    }
+
+    ~FastReader() {
+        if (mapped != nullptr) munmap(const_cast<char*>(mapped), mappedSize);
+        if (fd > STDIN_FILENO) close(fd);
+    }
 
-// функция для определения победителя игры
-int findWinner(int n, int m, const vector<int>& nums) {
-    // создаем массив dp, где dp[i] будет хранить максимальную разницу очков
-    // между текущим игроком и противником для i оставшихся чисел
-    vector<int> dp(n + 1, -1e9); // заполняем очень маленькими числами, так как будем искать максимум
-
-    // массив для хранения префиксных сумм (сумма первых i элементов)
-    vector<int> prefix(n + 1, 0);
-    // вычисляем префиксные суммы для быстрого нахождения суммы любых k элементов
-    for (int i = 1; i <= n; ++i) {
-        prefix[i] = prefix[i - 1] + nums[i - 1];
-    }
-
-    // базовый случай: если чисел не осталось (i=0), разница очков 0
-    dp[0] = 0;
-
-    // заполняем массив dp для всех возможных количеств оставшихся чисел
-    for (int i = 1; i <= n; ++i) {
-        // перебираем все возможные количества чисел k, которые можно взять на этом ходу (от 1 до m)
-        for (int k = 1; k <= m && k <= i; ++k) {
-            // сумма взятых k чисел (первые k из оставшихся i чисел)
-            int sum = prefix[i] - prefix[i - k];
-            // разница очков, если мы возьмем k чисел:
-            // sum (наши очки) минус лучший результат противника для оставшихся i-k чисел
-            int diff = sum - dp[i - k];
-            // если эта разница лучше текущей, обновляем dp[i]
-            if (diff > dp[i]) {
-                dp[i] = diff;
+    FastReader(const FastReader&) = delete;
+    FastReader& operator=(const FastReader&) = delete;
+
+    // удалось ли открыть источник
+    bool ok() const {
+        return !failed;
+    }
+
+    // читает очередное число, возвращает false в конце ввода или при ошибке разбора
+    bool next(long long& value) {
+        while (true) {
+            // пропускаем разделители
+            while (cur < end && static_cast<unsigned char>(*cur) <= ' ') ++cur;
+            if (cur == end) {
+                if (!refill()) return false;
+                continue;
+            }
+
+            // число могло оборваться на границе блока, поэтому перед разбором
+            // дочитываем, если в буфере осталось меньше самой длинной записи числа
+            if (!eof && end - cur < maxTokenLength) {
+                refill();
+                continue;
             }
+
+            auto [ptr, ec] = from_chars(cur, end, value);
+            if (ec != errc()) return false;
+            cur = ptr;
+            return true;
         }
     }
 
-    return dp[n] < 0 ? 1 : 0;
+private:
+    // дочитывает следующий блок stdin, сохраняя неразобранный хвост
+    bool refill() {
+        if (eof) return false;
+        size_t tail = end - cur;
+        memmove(buffer.data(), cur, tail);
+        ssize_t got;
+        do {
+            got = read(fd, buffer.data() + tail, buffer.size() - tail);
+        } while (got < 0 && errno == EINTR);
+        if (got <= 0) eof = true;
+        cur = buffer.data();
+        end = cur + tail + (got > 0 ? got : 0);
+        return got > 0;
+    }
+
+    static constexpr size_t blockSize = 1 << 20; // размер блока чтения stdin
+    static constexpr ptrdiff_t maxTokenLength = 32; // с запасом длиннее любого 64-битного числа
+    int fd = -1;
+    vector<char> buffer;            // буфер для stdin
+    const char* mapped = nullptr;   // отображенный в память файл
+    size_t mappedSize = 0;
+    const char* cur = nullptr;      // текущая позиция разбора
+    const char* end = nullptr;      // конец доступных данных
+    bool eof = false;               // источник прочитан до конца
+    bool failed = false;            // источник не удалось открыть
+};
+
+// решатели хранят числа и параметры игры в int, поэтому прочитанные значения проверяются
+bool fitsInt(long long value) {
+    return value >= INT_MIN && value <= INT_MAX;
 }
 
-int main() {
+// быстрый режим: без подсказок, числа читаются FastReader и сразу подаются решателю
+int runFast(const char* path, bool printPrefixes) {
+    FastReader reader(path);
+    if (!reader.ok()) {
+        cout << "ошибка при открытии файла" << endl;
+        return 1;
+    }
+
+    long long n, m;
+    if (!reader.next(n) || !reader.next(m) || n < 1 || m < 1) {
+        cout << "некорректные входные данные. убедитесь, что n >= 1 и m >= 1." << endl;
+        return 1;
+    }
+
+    // за ход нельзя взять больше оставшихся чисел, поэтому окно не длиннее n
+    long long window = min(m, n);
+    if (!fitsInt(window)) {
+        cout << "слишком большое окно: min(n, m) должно помещаться в int" << endl;
+        return 1;
+    }
+    StreamingWinner solver(static_cast<int>(window));
+    string out;
+    for (long long i = 0; i < n; ++i) {
+        long long number;
+        if (!reader.next(number)) {
+            cout << "введено неверное количество чисел" << endl;
+            return 1;
+        }
+        if (!fitsInt(number)) {
+            cout << "число " << number << " вне диапазона int" << endl;
+            return 1;
+        }
+        solver.push(static_cast<int>(number));
+        if (printPrefixes) {
+            out += to_string(i + 1);
+            out += ' ';
+            out += char('0' + solver.winner());
+            out += '\n';
+            // сбрасываем накопленный вывод крупными порциями
+            if (out.size() >= (1 << 16)) {
+                fwrite(out.data(), 1, out.size(), stdout);
+                out.clear();
+            }
+        }
+    }
+    fwrite(out.data(), 1, out.size(), stdout);
+
+    cout << "результат: " << solver.winner() << endl;
+    cout << "(1 - павел выиграл, 0 - вика выиграла)" << endl;
+    return 0;
+}
+
+// пакетный режим: в файле (или stdin) количество игр, затем для каждой n, m и n чисел
+// игры решаются параллельно, у каждого потока свои переиспользуемые буферы,
+// результаты выводятся в порядке игр во входных данных
+int runBatch(const char* path) {
+    FastReader reader(path);
+    if (!reader.ok()) {
+        cout << "ошибка при открытии файла" << endl;
+        return 1;
+    }
+
+    long long count;
+    if (!reader.next(count) || count < 0) {
+        cout << "некорректное количество игр" << endl;
+        return 1;
+    }
+
+    // читаем все игры в один общий массив чисел. заявленные размеры заранее не
+    // выделяются: массивы растут по мере чтения, поэтому завышенное количество игр
+    // или чисел приводит к ошибке разбора, а не к попытке выделить огромный буфер
+    vector<Game> games;
+    vector<int> numbers;
+    for (long long g = 0; g < count; ++g) {
+        long long n, m;
+        if (!reader.next(n) || !reader.next(m) || n < 1 || m < 1) {
+            cout << "некорректные входные данные в игре " << g + 1 << endl;
+            return 1;
+        }
+        if (!fitsInt(n)) {
+            cout << "слишком много чисел в игре " << g + 1 << endl;
+            return 1;
+        }
+        // окно длиннее игры не нужно, поэтому m ограничивается n
+        games.push_back({numbers.size(), static_cast<int>(n), static_cast<int>(min(m, n))});
+        for (long long i = 0; i < n; ++i) {
+            long long number;
+            if (!reader.next(number)) {
+                cout << "введено неверное количество чисел в игре " << g + 1 << endl;
+                return 1;
+            }
+            if (!fitsInt(number)) {
+                cout << "число " << number << " вне диапазона int в игре " << g + 1 << endl;
+                return 1;
+            }
+            numbers.push_back(static_cast<int>(number));
+        }
+    }
+
+    // игры решаются параллельно, результаты в порядке игр
+    vector<char> results(games.size());
+    solveGames(games, numbers.data(), results.data());
+
+    // выводим результаты в исходном порядке
+    string out;
+    out.reserve(results.size() * 2);
+    for (char result : results) {
+        out += char('0' + result);
+        out += '\n';
+    }
+    fwrite(out.data(), 1, out.size(), stdout);
+    return 0;
+}
+
+// режим изменений: n, m и n чисел, затем количество операций q и сами операции:
+// "1 i x" заменяет i-е число (с единицы) на x, "2" выводит победителя
+int runDynamic(const char* path) {
+    FastReader reader(path);
+    if (!reader.ok()) {
+        cout << "ошибка при открытии файла" << endl;
+        return 1;
+    }
+
+    long long n, m;
+    if (!reader.next(n) || !reader.next(m) || n < 1 || m < 1) {
+        cout << "некорректные входные данные. убедитесь, что n >= 1 и m >= 1." << endl;
+        return 1;
+    }
+    if (!fitsInt(n)) {
+        cout << "слишком много чисел" << endl;
+        return 1;
+    }
+    // массив растет по мере чтения, чтобы завышенное n не выделяло память заранее
+    vector<int> nums;
+    for (long long i = 0; i < n; ++i) {
+        long long number;
+        if (!reader.next(number)) {
+            cout << "введено неверное количество чисел" << endl;
+            return 1;
+        }
+        if (!fitsInt(number)) {
+            cout << "число " << number << " вне диапазона int" << endl;
+            return 1;
+        }
+        nums.push_back(static_cast<int>(number));
+    }
+
+    // окно длиннее последовательности не нужно, поэтому m ограничивается n
+    DynamicGame game(static_cast<int>(min(m, n)), nums);
+    long long q;
+    if (!reader.next(q)) q = 0;
+
+    string out;
+    for (long long k = 0; k < q; ++k) {
+        long long op;
+        if (!reader.next(op)) break;
+        if (op == 1) {
+            long long index, value;
+            if (!reader.next(index) || !reader.next(value) || index < 1 || index > n || !fitsInt(value)) {
+                cout << "некорректная операция " << k + 1 << endl;
+                return 1;
+            }
+            game.update(static_cast<int>(index - 1), static_cast<int>(value));
+        } else if (op == 2) {
+            out += char('0' + game.query());
+            out += '\n';
+        } else {
+            cout << "некорректная операция " << k + 1 << endl;
+            return 1;
+        }
+    }
+    fwrite(out.data(), 1, out.size(), stdout);
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    // с ключом --prefix победитель выводится после каждого прочитанного числа,
+    // с ключом --fast [файл] ввод читается быстрым разборщиком без подсказок,
+    // с ключом --batch [файл] решается пакет независимых игр,
+    // с ключом --dynamic [файл] обрабатываются изменения чисел и запросы победителя
+    bool printPrefixes = false;
+    bool fast = false;
+    bool batch = false;
+    bool dynamic = false;
+    const char* path = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--prefix") {
+            printPrefixes = true;
+        } else if (arg == "--fast") {
+            fast = true;
+        } else if (arg == "--batch") {
+            batch = true;
+        } else if (arg == "--dynamic") {
+            dynamic = true;
+        } else {
+            path = argv[i];
+            fast = true;
+        }
+    }
+    if (batch) {
+        return runBatch(path);
+    }
+    if (dynamic) {
+        return runDynamic(path);
+    }
+    if (fast) {
+        return runFast(path, printPrefixes);
+    }
+
     // ввод данных
     cout << "введите количество чисел в последовательности (n) и максимальное количество чисел для удаления за ход (m):" << endl;
     int n, m;
     cin >> n >> m;
 
     // проверка на корректность ввода
-    if (n < 1 || n > 50000 || m < 1 || m > 100) {
-        cout << "некорректные входные данные. убедитесь, что 1 <= n <= 50000 и 1 <= m <= 100." << endl;
+    if (n < 1 || m < 1) {
+        cout << "некорректные входные данные. убедитесь, что n >= 1 и m >= 1." << endl;
         return 1;
     }
 
     cout << "введите последовательность из " << n << " целых чисел:" << endl;
-    vector<int> nums(n);
+    // числа обрабатываются по мере чтения, вся последовательность в памяти не хранится,
+    // окно не длиннее n
+    StreamingWinner solver(min(m, n));
     for (int i = 0; i < n; ++i) {
-        cin >> nums[i];
+        int number;
+        cin >> number;
+        solver.push(number);
+        if (printPrefixes) {
+            cout << i + 1 << " " << solver.winner() << "\n";
+        }
     }
 
     // определяем победителя
-    int winner = findWinner(n, m, nums);
+    int winner = solver.winner();
 
     // выводим результат
     cout << "результат: " << winner << endl;
@@ -3,89 +3,394 @@
 #include <iomanip>
 #include <cmath>
 #include <fstream>
+#include <string>
+#include <sstream>
+#include <atomic>
+#include <charconv>
+#include <cstring>
+
+#include "lr3lib.h"
 
 using namespace std;
+using namespace lr3;
 
-// функция для моделирования остывания кофе
-vector<pair<double, double>> cofe(double tcof, double tmed, double k, double time, double step) {
-    vector<pair<double, double>> result;
-    double currentTime = 0.0;
-    double currentTemp = tcof;
-    result.push_back({currentTime, currentTemp});
-    
-    while (currentTime < time) {
-        currentTime += step;
-        currentTemp = tmed + (currentTemp - tmed) * exp(-k * step);
-        result.push_back({currentTime, currentTemp});
+// вывод таблицы по частям, чтобы строки можно было печатать по мере вычисления
+void printTableHeader() {
+    cout << "---------------------------------" << endl;
+    cout << "| время (мин) | температура (C) |" << endl;
+    cout << "---------------------------------" << endl;
+}
+
+void printTableRow(double time, double temp) {
+    cout << "| " << setw(11) << fixed << setprecision(2) << time 
+         << " | " << setw(15) << fixed << setprecision(1) << temp << " |" << endl;
+}
+
+void printTableFooter() {
+    cout << "---------------------------------" << endl;
+}
+
+// функция для вывода таблицы
+void printTable(const CoolingData& data) {
+    printTableHeader();
+    for (size_t i = 0; i < data.size(); ++i) {
+        printTableRow(data.time[i], data.temp[i]);
     }
-    
-    return result;
+    printTableFooter();
 }
 
-// функция для вычисления коэффициента корреляции и детерминации
-void korrel(const vector<pair<double, double>>& data, double& r, double& r2) {
-    double sumX = 0, sumY = 0, sumXY = 0, sumX2 = 0, sumY2 = 0;
-    int n = data.size();
-    
-    for (const auto& point : data) {
-        sumX += point.first;
-        sumY += point.second;
-        sumXY += point.first * point.second;
-        sumX2 += point.first * point.first;
-        sumY2 += point.second * point.second;
+// функция для записи данных в файл
+// формат выбирается по расширению: .bin - бинарный столбцовый, иначе csv
+void writeToFile(const CoolingData& data, const string& filename) {
+    bool saved = isBinaryFile(filename) ? writeBinary(data, filename) : writeCsv(data, filename);
+    if (saved) {
+        cout << "данные сохранены в файл: " << filename << endl;
+    } else {
+        cout << "ошибка при открытии файла" << endl;
     }
-    
-    r = (n * sumXY - sumX * sumY) / sqrt((n * sumX2 - sumX * sumX) * (n * sumY2 - sumY * sumY));
-    r2 = r * r;
 }
 
-// функция для вычисления аппроксимирующей прямой (y = a*x + b)
-void aprox(const vector<pair<double, double>>& data, double& a, double& b) {
-    double sumX = 0, sumY = 0, sumXY = 0, sumX2 = 0;
-    int n = data.size();
-    
-    for (const auto& point : data) {
-        sumX += point.first;
-        sumY += point.second;
-        sumXY += point.first * point.second;
-        sumX2 += point.first * point.first;
+// режим оценки по измерениям: из stdin читаются пары "время температура",
+// на каждую точку выводится "время k tmed", при заданном окне еще
+// уточненные по окну k и tmed
+int runOnline(size_t window, double lambda) {
+    OnlineCoolingFit fit(window, lambda);
+    double t, temp;
+    cout << setprecision(6);
+    while (cin >> t >> temp) {
+        fit.add(t, temp);
+        cout << t << " " << fit.k() << " " << fit.tmed();
+        if (window > 0) {
+            cout << " " << fit.refinedK() << " " << fit.refinedTmed();
+        }
+        cout << "\n";
     }
-    
-    a = (n * sumXY - sumX * sumY) / (n * sumX2 - sumX * sumX);
-    b = (sumY - a * sumX) / n;
+    return 0;
 }
 
-// функция для вывода таблицы
-void printTable(const vector<pair<double, double>>& data) {
-    cout << "---------------------------------" << endl;
-    cout << "| время (мин) | температура (C) |" << endl;
-    cout << "---------------------------------" << endl;
-    
-    for (const auto& row : data) {
-        cout << "| " << setw(11) << fixed << setprecision(2) << row.first 
-             << " | " << setw(15) << fixed << setprecision(1) << row.second << " |" << endl;
+// читает точки профиля среды "время температура" из файла, время должно возрастать
+bool loadAmbient(const string& filename, AmbientProfile& ambient) {
+    ifstream in(filename);
+    if (!in.is_open()) return false;
+    vector<pair<double, double>> loaded;
+    double t, temp;
+    while (in >> t >> temp) {
+        if (!loaded.empty() && t <= loaded.back().first) return false;
+        loaded.push_back({t, temp});
     }
-    
-    cout << "---------------------------------" << endl;
+    if (loaded.empty() || !in.eof()) return false;
+    ambient = AmbientProfile(move(loaded));
+    return true;
 }
 
-// функция для записи данных в файл
-void writeToFile(const vector<pair<double, double>>& data, const string& filename) {
-    ofstream outFile(filename);
-    if (outFile.is_open()) {
-        outFile << "время (мин),температура (C)" << endl;
-        for (const auto& row : data) {
-            outFile << fixed << setprecision(2) << row.first << "," 
-                    << fixed << setprecision(1) << row.second << endl;
+// разбирает поле сценария: число или сетка "начало:конец:количество"
+bool parseGrid(const string& field, vector<double>& values) {
+    values.clear();
+    double start, end;
+    long long count;
+    char sep1, sep2;
+    istringstream in(field);
+    if (field.find(':') == string::npos) {
+        if (!(in >> start) || !(in >> ws).eof()) return false;
+        values.push_back(start);
+        return true;
+    }
+    if (!(in >> start >> sep1 >> end >> sep2 >> count) || sep1 != ':' || sep2 != ':' || count < 1) {
+        return false;
+    }
+    for (long long i = 0; i < count; ++i) {
+        values.push_back(count == 1 ? start : start + (end - start) * i / (count - 1));
+    }
+    return true;
+}
+
+// читает сценарии из файла: в каждой строке tcof tmed k time step,
+// любое поле может быть сеткой "начало:конец:количество", тогда строка
+// разворачивается во все сочетания значений. пустые строки и строки с # пропускаются
+bool readScenarios(const string& filename, vector<Scenario>& scenarios) {
+    ifstream in(filename);
+    if (!in.is_open()) {
+        cout << "ошибка при открытии файла сценариев" << endl;
+        return false;
+    }
+
+    string line;
+    int lineNumber = 0;
+    while (getline(in, line)) {
+        ++lineNumber;
+        istringstream fields(line);
+        vector<string> parts;
+        string part;
+        while (fields >> part) parts.push_back(part);
+        if (parts.empty() || parts[0][0] == '#') continue;
+
+        vector<double> grid[5];
+        bool ok = parts.size() == 5;
+        for (size_t i = 0; ok && i < 5; ++i) {
+            ok = parseGrid(parts[i], grid[i]);
         }
-        outFile.close();
-        cout << "данные сохранены в файл: " << filename << endl;
+        if (!ok) {
+            cout << "некорректный сценарий в строке " << lineNumber << endl;
+            return false;
+        }
+
+        for (double tcof : grid[0])
+            for (double tmed : grid[1])
+                for (double k : grid[2])
+                    for (double time : grid[3])
+                        for (double step : grid[4]) {
+                            if (k <= 0 || time <= 0 || step <= 0 || step > time || coolingRows(time, step) == 0) {
+                                cout << "некорректные параметры в строке " << lineNumber << endl;
+                                return false;
+                            }
+                            scenarios.push_back({tcof, tmed, k, time, step});
+                        }
+    }
+    return true;
+}
+
+// режим перебора сценариев: все сценарии из файла моделируются на всех ядрах.
+// итоги пишутся по строке на сценарий в summaryFile, при заданном tracesDir
+// туда же сохраняются полные таблицы (scenario_<номер>.csv или .bin)
+int runSweep(const string& scenarioFile, const string& summaryFile,
+             const string& tracesDir, bool binaryTraces) {
+    vector<Scenario> scenarios;
+    if (!readScenarios(scenarioFile, scenarios)) return 1;
+
+    // таблицы сохраняются из потоков, которые их посчитали
+    atomic<bool> traceFailed{false};
+    auto saveTrace = [&](size_t i, const CoolingData& data) {
+        string path = tracesDir + "/scenario_" + to_string(i + 1) + (binaryTraces ? ".bin" : ".csv");
+        bool saved = binaryTraces ? writeBinary(data, path) : writeCsv(data, path);
+        if (!saved) traceFailed = true;
+    };
+    vector<SweepResult> results;
+    if (tracesDir.empty()) {
+        sweepScenarios(scenarios, results);
     } else {
+        sweepScenarios(scenarios, results, saveTrace);
+    }
+
+    BufferedWriter out(summaryFile);
+    if (!out.isOpen()) {
+        cout << "ошибка при открытии файла" << endl;
+        return 1;
+    }
+    out.write(string("номер,tcof,tmed,k,time,step,строк,r,r2,a,b\n"));
+    for (size_t i = 0; i < scenarios.size(); ++i) {
+        const Scenario& sc = scenarios[i];
+        const SweepResult& res = results[i];
+        out.write(to_string(i + 1));
+        for (double value : {sc.tcof, sc.tmed, sc.k, sc.time, sc.step}) {
+            out.put(',');
+            out.writeFixed(value, 6);
+        }
+        out.put(',');
+        out.write(to_string(res.rows));
+        for (double value : {res.r, res.r2, res.a, res.b}) {
+            out.put(',');
+            out.writeFixed(value, 6);
+        }
+        out.put('\n');
+    }
+    if (!out.close()) {
+        cout << "ошибка при записи файла" << endl;
+        return 1;
+    }
+
+    cout << "сценариев: " << scenarios.size() << ", итоги сохранены в файл: " << summaryFile << endl;
+    if (traceFailed) {
+        cout << "не все таблицы удалось сохранить в " << tracesDir << endl;
+    }
+    return 0;
+}
+
+// режим скользящего окна: для каждой точки, начиная с заполнения окна,
+// в csv пишутся время, r, наклон и свободный член по последним window точкам.
+// точки берутся из sim (если задан) или читаются парами "время температура" из stdin
+int runRolling(size_t window, const string& filename, const CoolingRange* sim) {
+    if (window < 2) {
+        cout << "окно должно содержать не меньше 2 точек" << endl;
+        return 1;
+    }
+    BufferedWriter out(filename);
+    if (!out.isOpen()) {
         cout << "ошибка при открытии файла" << endl;
+        return 1;
+    }
+    out.write(string("время (мин),r,a,b\n"));
+
+    RollingStats stats(window);
+    auto process = [&](double t, double temp) {
+        stats.add(t, temp);
+        if (!stats.full()) return;
+        out.writeFixed(t, 4);
+        for (double value : {stats.correlation(), stats.slope(), stats.intercept()}) {
+            out.put(',');
+            out.writeFixed(value, 6);
+        }
+        out.put('\n');
+    };
+
+    if (sim != nullptr) {
+        for (CoolingPoint point : *sim) process(point.time, point.temp);
+    } else {
+        ios::sync_with_stdio(false);
+        double t, temp;
+        while (cin >> t >> temp) process(t, temp);
     }
+
+    if (!out.close()) {
+        cout << "ошибка при записи файла" << endl;
+        return 1;
+    }
+    cout << "данные сохранены в файл: " << filename << endl;
+    return 0;
 }
 
-int main() {
+// разбирает число из аргумента командной строки целиком, без исключений.
+// from_chars принимает nan и inf, но ни один параметр не может быть бесконечным
+bool parseNumber(const char* text, double& value) {
+    const char* end = text + strlen(text);
+    auto [ptr, ec] = from_chars(text, end, value);
+    return ec == errc() && ptr == end && ptr != text && isfinite(value);
+}
+
+bool parseNumber(const char* text, size_t& value) {
+    const char* end = text + strlen(text);
+    auto [ptr, ec] = from_chars(text, end, value);
+    return ec == errc() && ptr == end && ptr != text;
+}
+
+// разбирает подряд идущие аргументы argv[first..] в values
+template <typename... T>
+bool parseNumbers(char* argv[], int first, T&... values) {
+    int i = first;
+    return (parseNumber(argv[i++], values) && ...);
+}
+
+// справка по ключам, выводится при неизвестном или неполном ключе
+int printUsage() {
+    cout << "использование:\n"
+         << "  lr3-5 [выход.csv|выход.bin]\n"
+         << "  lr3-5 --sweep сценарии [--out итоги.csv] [--traces каталог] [--binary]\n"
+         << "  lr3-5 --rolling окно выход.csv [tcof tmed k время шаг]\n"
+         << "  lr3-5 --online [окно] [коэффициент забывания]\n"
+         << "  lr3-5 --ode rk4|dp45 tcof k время шаг_или_точность среда [файл]" << endl;
+    return 1;
+}
+
+int main(int argc, char* argv[]) {
+    string mode = argc > 1 ? argv[1] : "";
+
+    // перебор сценариев: --sweep файл [--out итоги.csv] [--traces каталог] [--binary]
+    if (mode == "--sweep") {
+        if (argc < 3) return printUsage();
+        string summaryFile = "sweep_summary.csv";
+        string tracesDir;
+        bool binaryTraces = false;
+        for (int i = 3; i < argc; ++i) {
+            string arg = argv[i];
+            if (arg == "--out" && i + 1 < argc) {
+                summaryFile = argv[++i];
+            } else if (arg == "--traces" && i + 1 < argc) {
+                tracesDir = argv[++i];
+            } else if (arg == "--binary") {
+                binaryTraces = true;
+            } else {
+                return printUsage();
+            }
+        }
+        return runSweep(argv[2], summaryFile, tracesDir, binaryTraces);
+    }
+
+    // скользящее окно: --rolling окно выход.csv [tcof tmed k время шаг]
+    // без параметров моделирования точки читаются из stdin
+    if (mode == "--rolling") {
+        if (argc != 4 && argc != 9) return printUsage();
+        size_t window;
+        if (!parseNumber(argv[2], window)) {
+            cout << "некорректный размер окна: " << argv[2] << endl;
+            return 1;
+        }
+        if (argc == 9) {
+            double tcof, tmed, k, time, step;
+            if (!parseNumbers(argv, 4, tcof, tmed, k, time, step) || k <= 0 || time <= 0 || step <= 0 ||
+                step > time) {
+                cout << "некорректные параметры моделирования" << endl;
+                return 1;
+            }
+            CoolingRange sim(tcof, tmed, k, time, step);
+            if (sim.size() == 0) {
+                cout << "слишком много шагов: уменьшите время или увеличьте шаг" << endl;
+                return 1;
+            }
+            return runRolling(window, argv[3], &sim);
+        }
+        return runRolling(window, argv[3], nullptr);
+    }
+
+    // оценка по измерениям: --online [окно] [коэффициент забывания]
+    if (mode == "--online") {
+        if (argc > 4) return printUsage();
+        size_t window = 0;
+        double lambda = 1.0;
+        if ((argc > 2 && !parseNumber(argv[2], window)) || (argc > 3 && !parseNumber(argv[3], lambda))) {
+            cout << "некорректные параметры оценки" << endl;
+            return 1;
+        }
+        if (lambda <= 0 || lambda > 1) {
+            cout << "коэффициент забывания должен быть в (0, 1]" << endl;
+            return 1;
+        }
+        return runOnline(window, lambda);
+    }
+
+    // интегрирование с переменной средой:
+    // --ode rk4|dp45 tcof k время шаг_или_точность среда [файл]
+    // среда - число (постоянная температура) или файл с точками "время температура"
+    if (mode == "--ode") {
+        if (argc != 8 && argc != 9) return printUsage();
+        string method = argv[2];
+        double tcof, k, time, param;
+        if (!parseNumbers(argv, 3, tcof, k, time, param) || k <= 0 || time <= 0 || param <= 0 ||
+            (method != "rk4" && method != "dp45")) {
+            cout << "некорректные параметры интегрирования" << endl;
+            return 1;
+        }
+        AmbientProfile ambient;
+        double constant;
+        if (parseNumber(argv[7], constant)) {
+            ambient = AmbientProfile(constant);
+        } else if (!loadAmbient(argv[7], ambient)) {
+            cout << "ошибка при чтении файла температуры среды" << endl;
+            return 1;
+        }
+
+        if (method == "dp45" && param < minDormandPrinceTolerance) {
+            cout << "точность должна быть не меньше " << minDormandPrinceTolerance << endl;
+            return 1;
+        }
+
+        CoolingData result;
+        bool solved = method == "rk4" ? integrateRK4(tcof, k, ambient, time, param, result)
+                                      : integrateDormandPrince(tcof, k, ambient, time, param, result);
+        if (!solved) {
+            cout << "интегрирование не удалось: шаг слишком мал для заданного времени" << endl;
+            return 1;
+        }
+        printTable(result);
+        cout << "шагов: " << result.size() - 1 << endl;
+        writeToFile(result, argc > 8 ? argv[8] : "coffee_data.csv");
+        return 0;
+    }
+
+    // любой другой ключ - ошибка, а не имя выходного файла
+    if (mode.rfind("--", 0) == 0 || argc > 2) return printUsage();
+
+    // имя файла для сохранения можно передать первым аргументом
+    string filename = argc > 1 ? argv[1] : "coffee_data.csv";
+
     double tcof, tmed, k, time, step;
     
     cout << "моделирование остывания кофе" << endl;
@@ -95,34 +400,61 @@ int main() {
     cin >> tmed;
     cout << "введите коэффициент остывания (>0): ";
     cin >> k;
-    while (k <= 0) {
+    while (cin && k <= 0) {
         cout << "коэффициент должен быть >0, введите снова: ";
         cin >> k;
     }
     cout << "введите время моделирования (мин): ";
     cin >> time;
-    while (time <= 0) {
+    while (cin && time <= 0) {
         cout << "время должно быть >0, введите снова: ";
         cin >> time;
     }
     cout << "введите шаг по времени (мин): ";
     cin >> step;
-    while (step <= 0 || step > time) {
+    while (cin && (step <= 0 || step > time)) {
         cout << "шаг должен быть >0 и <общего времени, введите снова: ";
         cin >> step;
     }
+    // ввод оборвался или содержит не число
+    if (!cin) {
+        cout << "\nошибка ввода" << endl;
+        return 1;
+    }
     
-    vector<pair<double, double>> result = cofe(tcof, tmed, k, time, step);
-    printTable(result);
-    writeToFile(result, "coffee_data.csv");
-    
+    // точки вычисляются по одной и за один проход попадают в таблицу,
+    // в файл и в статистику, вся траектория в памяти не хранится
+    CoolingRange range(tcof, tmed, k, time, step);
+    if (range.size() == 0) {
+        cout << "слишком много шагов: уменьшите время или увеличьте шаг" << endl;
+        return 1;
+    }
+    bool binary = isBinaryFile(filename);
+    CsvExporter csv(binary ? string() : filename);
+    StatsAccumulator stats;
+
+    printTableHeader();
+    for (CoolingPoint point : range) {
+        printTableRow(point.time, point.temp);
+        if (csv.isOpen()) csv.row(point.time, point.temp);
+        stats.add(point.time, point.temp);
+    }
+    printTableFooter();
+
+    bool saved = binary ? writeBinary(range, filename) : csv.close();
+    if (saved) {
+        cout << "данные сохранены в файл: " << filename << endl;
+    } else {
+        cout << "ошибка при открытии файла" << endl;
+    }
+
     double r, r2;
-    korrel(result, r, r2);
+    korrel(stats, r, r2);
     cout << "коэффициент корреляции: " << r << endl;
     cout << "коэффициент детерминации: " << r2 << endl;
     
     double a, b;
-    aprox(result, a, b);
+    aprox(stats, a, b);
     cout << "аппроксимирующая прямая: y = " << a << " * x + " << b << endl;
     
     return 0;
@@ -0,0 +1,1605 @@
+// реализация вычислительных функций всех программ лабораторной работы
+// функции ничего не выводят и не читают с консоли, случайные числа берутся
+// из генератора вызывающего, результаты пишутся в переданные буферы
+#include "lr3lib.h"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <climits>
+#include <limits>
+#include <cmath>
+#include <numeric>
+#include <set>
+#include <sstream>
+#include <thread>
+
+using namespace std;
+
+namespace lr3 {
+
+// функция для вычисления значения y в зависимости от x
+double calculateY(double x) {
+    // если x в диапазоне от -5 до -2 (включительно)
+    if (x >= -5 && x <= -2) {
+        // вычисляем y для прямой, проходящей через точки (-5,-1) и (-2,0)
+        // уравнение прямой: (y - y1)/(y2 - y1) = (x - x1)/(x2 - x1)
+        return (1.0 / 3.0) * (x + 5) - 1;
+    }
+    // если x в диапазоне от -2 до 0 (не включая 0)
+    else if (x > -2 && x < 0) {
+        // горизонтальная линия y=0
+        return 0.5 * (x + 2) - 1;
+    }
+    // если x в диапазоне от 0 до 2 (не включая 2)
+    else if (x >= 0 && x < 2) {
+        // вычисляем тангенс от x/2
+        return tan(x / 2.0);
+    }
+    // если x в диапазоне от 2 до 3 (не включая 3)
+    else if (x >= 2 && x < 3) {
+        // прямая, проходящая через точки (2,tan(1)) и (3,0)
+        // угловой коэффициент k = (0 - tan(1))/(3 - 2) = -tan(1)
+        return -tan(1.0) * (x - 2) + tan(1.0);
+    }
+    // если x в диапазоне от 3 до 5 (включительно)
+    else if (x >= 3 && x <= 5) {
+        // прямая, проходящая через точки (3,0) и (5,1)
+        // угловой коэффициент k = (1 - 0)/(5 - 3) = 0.5
+        return 0.5 * (x - 3);
+    }
+    // если x вне заданного диапазона
+    else {
+        // возвращаем "не число" (nan)
+        return NAN;
+    }
+}
+
+// функция для быстрого возведения в степень по модулю
+// принимает основание, показатель степени и модуль
+// возвращает результат возведения в степень по модулю
+int modPow(int base, int exponent, int modulus) {
+    // инициализируем результат, произведения считаются в 64 битах,
+    // иначе при модуле больше 46340 квадрат основания переполняет int
+    long long result = 1;
+    // берем основание по модулю, чтобы избежать переполнения
+    long long current = base % modulus;
+    
+    // основной цикл возведения в степень
+    while (exponent > 0) {
+        // если показатель степени нечетный
+        if (exponent % 2 == 1) {
+            // умножаем результат на основание по модулю
+            result = (result * current) % modulus;
+        }
+        // делим показатель степени на 2
+        exponent >>= 1;
+        // возводим основание в квадрат по модулю
+        current = (current * current) % modulus;
+    }
+    // возвращаем конечный результат
+    return static_cast<int>(result);
+}
+
+// реализация решета эратосфена для нахождения всех простых чисел до n
+// возвращает вектор простых чисел
+vector<int> sieveOfEratosthenes(int n) {
+    // если n меньше 2, возвращаем пустой вектор
+    if (n < 2) return {};
+
+    // создаем вектор булевых значений, изначально все true
+    vector<bool> is_prime(n + 1, true);
+    is_prime[0] = is_prime[1] = false;
+
+    // основной цикл просеивания
+    for (int p = 2; p * p <= n; ++p) {
+        if (is_prime[p]) {
+            // отмечаем все кратные p числа как составные
+            for (int multiple = p * p; multiple <= n; multiple += p) {
+                is_prime[multiple] = false;
+            }
+        }
+    }
+
+    // собираем все простые числа в вектор
+    vector<int> primes;
+    for (int i = 2; i <= n; ++i) {
+        if (is_prime[i]) {
+            primes.push_back(i);
+        }
+    }
+
+    return primes;
+}
+
+// простые числа до 500 для генерации кандидатов
+// таблица строится один раз при первом обращении и дальше только читается
+const vector<int>& smallPrimes() {
+    static const vector<int> primes = sieveOfEratosthenes(500);
+    return primes;
+}
+
+// генерация случайного целого числа в диапазоне [min, max]
+int getRandomInt(mt19937& gen, int min, int max) {
+    // создаем равномерное распределение в заданном диапазоне
+    uniform_int_distribution<int> dist(min, max);
+    // возвращаем случайное число
+    return dist(gen);
+}
+
+// генерация случайного вещественного числа в диапазоне [0.0, 1.0)
+double getRandomDouble(mt19937& gen) {
+    uniform_real_distribution<double> dist(0.0, 1.0);
+    // возвращаем случайное число
+    return dist(gen);
+}
+
+// наибольший общий делитель двух чисел
+int gcdInt(int a, int b) {
+    while (b != 0) {
+        int temp = b;
+        b = a % b;
+        a = temp;
+    }
+    return a;
+}
+
+// простота небольшого числа перебором делителей
+bool isSmallPrime(int q) {
+    if (q < 2) return false;
+    for (int d = 2; d <= q / d; ++d) {
+        if (q % d == 0) return false;
+    }
+    return true;
+}
+
+// строит сертификат для n по известным простым делителям n-1
+// возвращает false, если делителей недостаточно или основание не найдено
+bool buildCertificate(int n, const vector<int>& factors, PrimeCertificate& cert) {
+    cert.n = n;
+    cert.witnesses.clear();
+    if (n < 3 || n % 2 == 0) return false;
+
+    // различные простые делители n-1, двойка делит n-1 всегда
+    set<int> primes(factors.begin(), factors.end());
+    primes.insert(2);
+
+    // часть n-1, разложенная на известные множители
+    long long F = 1;
+    for (int q : primes) {
+        if ((n - 1) % q != 0) return false;
+        for (int rest = n - 1; rest % q == 0; rest /= q) F *= q;
+    }
+    if (F * F <= n) return false;
+
+    // для каждого q ищем подходящее основание среди небольших чисел
+    for (int q : primes) {
+        bool found = false;
+        for (int a = 2; a < n && a < 1000; ++a) {
+            if (modPow(a, n - 1, n) != 1) return false; // n точно составное
+            int x = modPow(a, (n - 1) / q, n);
+            // x - 1 по модулю n без переполнения int при n больше 2^30
+            if (gcdInt(x == 0 ? n - 1 : x - 1, n) == 1) {
+                cert.witnesses.push_back({q, a});
+                found = true;
+                break;
+            }
+        }
+        if (!found) return false;
+    }
+    return true;
+}
+
+// проверка сертификата: несколько возведений в степень на каждый делитель
+bool verifyCertificate(const PrimeCertificate& cert) {
+    int n = cert.n;
+    if (n == 2) return cert.witnesses.empty();
+    if (n < 3 || n % 2 == 0) return false;
+
+    long long F = 1;
+    set<int> seen;
+    for (auto [q, a] : cert.witnesses) {
+        if (!seen.insert(q).second) return false; // делители не должны повторяться
+        if (!isSmallPrime(q) || (n - 1) % q != 0) return false;
+        if (a < 2 || a >= n) return false;
+        if (modPow(a, n - 1, n) != 1) return false;
+        int x = modPow(a, (n - 1) / q, n);
+        if (gcdInt(x == 0 ? n - 1 : x - 1, n) != 1) return false;
+        for (int rest = n - 1; rest % q == 0; rest /= q) F *= q;
+    }
+    return F * F > n;
+}
+
+// запись сертификата в строку вида "n q1:a1 q2:a2 ..."
+string formatCertificate(const PrimeCertificate& cert) {
+    string text = to_string(cert.n);
+    for (auto [q, a] : cert.witnesses) {
+        text += " " + to_string(q) + ":" + to_string(a);
+    }
+    return text;
+}
+
+// разбор сертификата из строки вида "n q1:a1 q2:a2 ..."
+bool parseCertificate(const string& line, PrimeCertificate& cert) {
+    istringstream in(line);
+    if (!(in >> cert.n)) return false;
+    cert.witnesses.clear();
+    string pairText;
+    while (in >> pairText) {
+        int q, a;
+        char sep;
+        istringstream pairIn(pairText);
+        if (!(pairIn >> q >> sep >> a) || sep != ':' || !(pairIn >> ws).eof()) return false;
+        cert.witnesses.push_back({q, a});
+    }
+    return true;
+}
+
+// класс для реализации алгоритма поклингтона
+
+// метод для проверки числа на простоту по тесту поклингтона
+// принимает число для проверки, количество тестов и вектор множителей
+// возвращает true, если число вероятно простое
+bool PocklingtonPrimality::isPrime(int n, int tests, const vector<int>& factors, mt19937& gen) {
+    // множество для хранения уникальных баз
+    set<int> usedBases;
+
+    // генерируем необходимое количество уникальных баз
+    while (usedBases.size() != static_cast<size_t>(tests)) {
+        // получаем случайное основание
+        int base = getRandomInt(gen, 2, n - 1);
+        // добавляем в множество
+        usedBases.insert(base);
+    }
+
+    // проверка первого условия теста поклингтона
+    for (int base : usedBases) {
+        // если a^(n-1) не сравнимо с 1 по модулю n
+        if (modPow(base, n - 1, n) != 1) {
+            // число составное
+            return false;
+        }
+    }
+
+    // проверка второго условия теста поклингтона
+    for (int base : usedBases) {
+        // флаг, что число составное
+        bool isComposite = true;
+        // проверяем для каждого множителя
+        for (int factor : factors) {
+            // если a^((n-1)/q) сравнимо с 1 по модулю n
+            if (modPow(base, (n - 1) / factor, n) == 1) {
+                // число может быть простым
+                isComposite = false;
+                break;
+            }
+        }
+        // если для всех множителей условие выполнено
+        if (isComposite) {
+            // число вероятно простое
+            return true;
+        }
+    }
+
+    // если не нашли подходящего основания, число составное
+    return false;
+}
+
+// генерация кандидата на простое число и его множителей
+// принимает вектор простых чисел и битовую длину
+// возвращает кортеж из кандидата и вектора множителей
+tuple<int, vector<int>> PocklingtonPrimality::generateCandidate(const vector<int>& primes, int bits,
+                                                                mt19937& gen) {
+    // максимальный индекс в векторе простых чисел
+    int maxIndex = primes.size() - 1;
+    // минимальное значение для R
+    int min = bits / 2 + 1;
+    // максимальное значение для R
+    int max = bits / 2 + 2;
+    // 2 в степени max
+    int powMax = pow(2, max);
+
+    // вычисляем максимальную степень для множителей
+    int maxPow = 1;
+    while (pow(2, maxPow) < pow(2, (bits / 2) + 1)) {
+        maxPow++;
+    }
+
+    // инициализация множителя f
+    int f = 1;
+    // вектор для хранения множителей
+    vector<int> factorList;
+
+    // генерация множителей f
+    while (true) {
+        // выбираем случайный индекс простого числа
+        int randIdx = getRandomInt(gen, 0, maxIndex);
+        // выбираем случайную степень
+        int randPow = getRandomInt(gen, 1, maxPow);
+
+        // проверяем, что произведение не превышает powMax
+        if (f * pow(primes[randIdx], randPow) < powMax) {
+            // умножаем f на простое число в степени
+            f *= pow(primes[randIdx], randPow);
+            // добавляем простое число в список множителей
+            factorList.push_back(primes[randIdx]);
+        }
+
+        // если f вышло за границы
+        if (f > pow(2, (bits / 2))) {
+            // если f слишком большое, начинаем заново
+            if (f >= pow(2, (bits / 2) + 1)) {
+                f = 1;
+                factorList.clear();
+            } else {
+                // иначе завершаем генерацию
+                break;
+            }
+        }
+    }
+
+    // генерируем случайное R
+    int R = getRandomInt(gen, min - 1, max - 1);
+    // делаем R четным
+    if (R % 2 != 0) R++;
+    // вычисляем кандидата n = R*f + 1
+    int candidate = R * f + 1;
+    // возвращаем кандидата и множители
+    return make_tuple(candidate, factorList);
+}
+
+
+// вспомогательный метод для теста миллера-рабина
+// принимает число для проверки и количество тестов
+// возвращает true, если число вероятно простое
+bool PocklingtonPrimality::millerRabinTest(int num, int tests, mt19937& gen) {
+    // обработка тривиальных случаев
+    if (num == 2 || num == 3) return true;
+    if (num < 2 || num % 2 == 0) return false;
+
+    // раскладываем num-1 на d * 2^s
+    int d = num - 1;
+    int s = 0;
+    while (d % 2 == 0) {
+        d /= 2;
+        s++;
+    }
+
+    // проводим указанное количество тестов
+    for (int i = 0; i < tests; i++) {
+        // выбираем случайное основание
+        int a = getRandomInt(gen, 2, num - 2);
+        // вычисляем x = a^d mod num
+        int x = modPow(a, d, num);
+        int y;
+        
+        // проводим s итераций
+        for (int j = 0; j < s; j++) {
+            // вычисляем y = x^2 mod num
+            y = modPow(x, 2, num);
+            // проверяем условия
+            if (y == 1 && x != 1 && x != (num - 1)) {
+                // число составное
+                return false;
+            }
+            x = y;
+        }
+        // проверяем окончательное условие
+        if (y != 1) {
+            // число составное
+            return false;
+        }
+    }
+    // если все тесты пройдены, число вероятно простое
+    return true;
+}
+
+// метод для генерации простых чисел алгоритмом поклингтона
+// принимает битовую длину, количество тестов и количество чисел для генерации,
+// найденные числа записываются в found (прежнее содержимое удаляется)
+void PocklingtonPrimality::generatePrimes(int bits, int tests, int count, mt19937& gen,
+                                          vector<GeneratedPrime>& found) {
+    // получаем список простых чисел до 500
+    const vector<int>& primes = smallPrimes();
+    found.clear();
+    // счетчик текущих попыток
+    int currentAttempts = 0;
+
+    // генерируем указанное количество простых чисел
+    while (found.size() < static_cast<size_t>(count)) {
+        // генерируем кандидата и его множители
+        int n;
+        vector<int> factors;
+        tie(n, factors) = generateCandidate(primes, bits, gen);
+
+        // проверяем кандидата на простоту
+        if (isPrime(n, tests, factors, gen)) {
+            // если число прошло тест, добавляем в результат
+            GeneratedPrime result;
+            result.prime = n;
+            // дополнительная проверка тестом миллера-рабина
+            result.confirmed = millerRabinTest(n, 3, gen);
+            // сохраняем количество попыток
+            result.attempts = currentAttempts;
+            // строим сертификат по уже известным множителям n-1
+            result.certified = buildCertificate(n, factors, result.certificate);
+            found.push_back(result);
+            // сбрасываем счетчик попыток
+            currentAttempts = 0;
+        } else {
+            // если число не прошло тест
+            if (millerRabinTest(n, 1, gen)) {
+                // увеличиваем счетчик попыток
+                currentAttempts++;
+            }
+        }
+    }
+}
+
+// класс для реализации алгоритма миллера
+
+// метод для проверки числа на простоту по тесту миллера
+// принимает кандидата, количество тестов и вектор множителей
+// возвращает true, если число вероятно простое
+bool MillerPrimality::isPrime(int candidate, int testCount, const vector<int>& factors, mt19937& gen) {
+    // множество для хранения уникальных баз
+    set<int> bases;
+
+    // генерируем необходимое количество уникальных баз
+    while (bases.size() < static_cast<size_t>(testCount)) {
+        // получаем случайное основание
+        int base = getRandomInt(gen, 2, candidate - 2);
+        // добавляем в множество
+        bases.insert(base);
+    }
+
+    // проверка первого условия теста миллера
+    for (int base : bases) {
+        // если a^(n-1) не сравнимо с 1 по модулю n
+        if (modPow(base, candidate - 1, candidate) != 1) {
+            // число составное
+            return false;
+        }
+    }
+
+    // проверка второго условия теста миллера
+    for (int factor : factors) {
+        // флаг, что все основания дали 1
+        bool allOnes = true;
+        // проверяем для каждого основания
+        for (int base : bases) {
+            // вычисляем показатель степени
+            int exponent = (candidate - 1) / factor;
+            // если a^((n-1)/q) не сравнимо с 1 по модулю n
+            if (modPow(base, exponent, candidate) != 1) {
+                // не все основания дали 1
+                allOnes = false;
+                break;
+            }
+        }
+        // если для какого-то множителя все основания дали 1
+        if (allOnes) {
+            // число составное
+            return false;
+        }
+    }
+
+    // если все условия выполнены, число вероятно простое
+    return true;
+}
+
+// генерация кандидата на простое число и его множителей
+// принимает вектор простых чисел и битовую длину
+// возвращает пару из кандидата и вектора множителей
+pair<int, vector<int>> MillerPrimality::generateCandidate(const vector<int>& primes, int bitLength,
+                                                          mt19937& gen) {
+    // нижняя граница для m
+    const int lowerBound = pow(2, bitLength - 2);
+    // верхняя граница для m
+    const int upperBound = pow(2, bitLength - 1) - 1;
+    
+    // инициализация m
+    int m = 1;
+    // вектор для хранения множителей
+    vector<int> factors;
+
+    // генерация множителей m
+    while (true) {
+        // выбираем случайный индекс простого числа
+        int randomIndex = getRandomInt(gen, 0, primes.size() - 1);
+        // получаем простое число по индексу
+        int randomPrime = primes[randomIndex];
+        
+        // проверяем, не превысили ли верхнюю границу
+        if (m * randomPrime > upperBound) {
+            // если достигли нижней границы, завершаем
+            if (m >= lowerBound) break;
+            // иначе начинаем заново
+            m = 1;
+            factors.clear();
+            continue;
+        }
+        
+        // умножаем m на простое число
+        m *= randomPrime;
+        // добавляем простое число в множители
+        factors.push_back(randomPrime);
+    }
+
+    // возвращаем кандидата n = 2*m + 1 и множители
+    return {2 * m + 1, factors};
+}
+
+
+// тест миллера-рабина, открыт для использования вне класса (например, в замерах)
+// принимает число для проверки и количество тестов
+// возвращает true, если число вероятно простое
+bool MillerPrimality::millerRabinTest(int num, int count, mt19937& gen) {
+    // обработка тривиальных случаев
+    if (num == 2 || num == 3) return true;
+    if (num % 2 == 0 || num < 2) return false;
+
+    // раскладываем num-1 на d * 2^s
+    int d = num - 1;
+    int s = 0;
+    while (d % 2 == 0) {
+        d /= 2;
+        ++s;
+    }
+
+    // проводим указанное количество тестов
+    for (int i = 0; i < count; ++i) {
+        // выбираем случайное основание
+        int a = getRandomInt(gen, 2, num - 2);
+        // вычисляем x = a^d mod num
+        int x = modPow(a, d, num);
+        
+        // если x равно 1 или num-1, переходим к следующему тесту
+        if (x == 1 || x == num - 1) continue;
+        
+        // флаг, что число составное
+        bool composite = true;
+        // проводим s-1 итераций
+        for (int j = 0; j < s - 1; ++j) {
+            // вычисляем x = x^2 mod num
+            x = modPow(x, 2, num);
+            // если x равно num-1, число вероятно простое
+            if (x == num - 1) {
+                composite = false;
+                break;
+            }
+        }
+        
+        // если составное, возвращаем false
+        if (composite) return false;
+    }
+    
+    // если все тесты пройдены, число вероятно простое
+    return true;
+}
+
+// метод для генерации простых чисел алгоритмом миллера
+// принимает битовую длину, количество тестов и количество чисел для генерации,
+// найденные числа записываются в found (прежнее содержимое удаляется)
+void MillerPrimality::generatePrimes(int bitLength, int testCount, int targetCount, mt19937& gen,
+                                     vector<GeneratedPrime>& found) {
+    // получаем список простых чисел до 500
+    const vector<int>& primes = smallPrimes();
+    found.clear();
+    // счетчик текущих попыток
+    int attempts = 0;
+
+    // генерируем указанное количество простых чисел
+    while (found.size() < static_cast<size_t>(targetCount)) {
+        // генерируем кандидата и его множители
+        auto [candidate, factors] = generateCandidate(primes, bitLength, gen);
+
+        // проверяем кандидата на простоту
+        if (isPrime(candidate, testCount, factors, gen)) {
+            // если число прошло тест, добавляем в результат
+            GeneratedPrime result;
+            result.prime = candidate;
+            // дополнительная проверка тестом миллера-рабина
+            result.confirmed = millerRabinTest(candidate, 3, gen);
+            // сохраняем количество попыток
+            result.attempts = attempts;
+            // строим сертификат: n-1 = 2*m разложено полностью
+            result.certified = buildCertificate(candidate, factors, result.certificate);
+            found.push_back(result);
+            // сбрасываем счетчик попыток
+            attempts = 0;
+        } else {
+            // если число не прошло тест
+            if (millerRabinTest(candidate, 1, gen)) {
+                // увеличиваем счетчик попыток
+                ++attempts;
+            }
+        }
+    }
+}
+
+// класс для реализации алгоритма гост р 34.10-94
+
+// метод для генерации простого числа по гост
+// принимает вектор простых чисел и битовую длину
+// возвращает простое число
+int GOSTPrimality::generatePrime(const vector<int>& primes, int bitLen, mt19937& gen) {
+    // вычисляем длину q в битах
+    int qBitLen = (bitLen + 1) / 2;
+    // минимальное значение для q
+    int qMin = 0;
+    // максимальное значение для q
+    int qMax = (1 << qBitLen) - 1;
+
+    // основной цикл генерации простого числа p
+    while (true) {
+        // выбираем простое число q подходящего размера заново на каждой попытке:
+        // для некоторых q в диапазоне длины bitLen нет подходящего p
+        int q;
+        do {
+            q = primes[getRandomInt(gen, 0, primes.size() - 1)];
+        } while (q < qMin || q > qMax);
+
+        // генерируем случайное число ξ в диапазоне [0, 1)
+        double ξ = getRandomDouble(gen);
+        // вычисляем n по формуле
+        double n = (double(1 << (bitLen - 1)) + (ξ * double(1 << (bitLen - 1)))) / q;
+        // преобразуем n в целое число
+        int nInt = int(n);
+        // если nInt нечетное, делаем его четным
+        if (nInt % 2 != 0) nInt++;
+
+        // поиск подходящего p = (nInt + k)*q + 1
+        for (int k = 0; ; k += 2) {
+            // вычисляем кандидата p
+            int p = (nInt + k) * q + 1;
+            // если p превысило максимальное значение, выходим из цикла
+            if (p > (1 << bitLen)) break;
+
+            // проверка условий простоты
+            if (modPow(2, p - 1, p) == 1 && modPow(2, nInt + k, p) != 1) {
+                // если условия выполнены, возвращаем p
+                return p;
+            }
+        }
+    }
+}
+
+
+// вспомогательный метод для теста миллера-рабина
+// принимает число для проверки и количество тестов
+// возвращает true, если число вероятно простое
+bool GOSTPrimality::millerRabinTest(int num, int tests, mt19937& gen) {
+    // обработка тривиальных случаев
+    if (num == 2 || num == 3) return true;
+    if (num < 2 || num % 2 == 0) return false;
+
+    // раскладываем num-1 на d * 2^s
+    int d = num - 1;
+    int s = 0;
+    while (d % 2 == 0) {
+        d /= 2;
+        s++;
+    }
+
+    // проводим указанное количество тестов
+    for (int i = 0; i < tests; i++) {
+        // выбираем случайное основание
+        int a = getRandomInt(gen, 2, num - 2);
+        // вычисляем x = a^d mod num
+        int x = modPow(a, d, num);
+        int y;
+        
+        // проводим s итераций
+        for (int j = 0; j < s; j++) {
+            // вычисляем y = x^2 mod num
+            y = modPow(x, 2, num);
+            // проверяем условия
+            if (y == 1 && x != 1 && x != (num - 1)) {
+                // число составное
+                return false;
+            }
+            x = y;
+        }
+        // проверяем окончательное условие
+        if (y != 1) {
+            // число составное
+            return false;
+        }
+    }
+    // если все тесты пройдены, число вероятно простое
+    return true;
+}
+
+// метод для генерации простых чисел по гост
+// принимает битовую длину, количество тестов и количество чисел для генерации,
+// уникальные простые числа записываются в found по возрастанию,
+// progress (если задан) вызывается после каждого найденного числа.
+// возвращает количество отвергнутых чисел
+int GOSTPrimality::generatePrimes(int bitLength, int testRounds, int targetCount, mt19937& gen,
+                                  vector<int>& found,
+                                  const function<void(size_t, size_t)>& progress) {
+    // множество для хранения уникальных простых чисел
+    set<int> primesSet;
+    // получаем список простых чисел до 500
+    const vector<int>& primes = smallPrimes();
+    // счетчик отвергнутых чисел
+    int rejected = 0;
+
+    // генерируем указанное количество уникальных простых чисел
+    while (primesSet.size() < static_cast<size_t>(targetCount)) {
+        // генерируем кандидата p
+        int p = generatePrime(primes, bitLength, gen);
+        // если число уже есть в множестве, пропускаем его
+        if (primesSet.count(p)) continue;
+
+        // проверяем кандидата тестом миллера-рабина
+        if (millerRabinTest(p, testRounds, gen)) {
+            // если тест пройден, добавляем число в множество
+            primesSet.insert(p);
+            if (progress) progress(primesSet.size(), targetCount);
+        } else {
+            // увеличиваем счетчик отвергнутых чисел
+            rejected++;
+        }
+    }
+
+    found.assign(primesSet.begin(), primesSet.end());
+    return rejected;
+}
+
+// функция для нахождения наибольшего общего делителя двух чисел
+int findGCD(int firstNum, int secondNum) {
+    while (secondNum != 0) { // пока второе число не ноль
+        int temp = secondNum; // сохраняем второе число
+        secondNum = firstNum % secondNum; // находим остаток от деления
+        firstNum = temp; // меняем первое число на бывшее второе
+    }
+    return firstNum; // возвращаем НОД
+}
+
+// функция для вычисления суммы ряда
+pair<int, int> computeSeriesSum(int power, int base) {
+    // если степень равна 0, это базовый случай
+    if (power == 0) {
+        return {1, base - 1}; // возвращаем 1/(b-1)
+    }
+
+    // вычисляем сумму предыдущих членов
+    int totalNumerator = 0; // общий числитель
+    int totalDenominator = 1; // общий знаменатель
+
+    // суммируем все члены от 0 до power-1
+    for (int currentPower = 0; currentPower < power; currentPower++) {
+        auto [currentNum, currentDen] = computeSeriesSum(currentPower, base); // получаем текущий член
+        // (a/b + c/d = (ad + cb)/(b*d))
+        // приводим к общему знаменателю
+        int newNum = totalNumerator * currentDen + currentNum * totalDenominator;
+        int newDen = totalDenominator * currentDen;
+
+        // сокращаем дробь
+        int gcdValue = findGCD(newNum, newDen);
+        totalNumerator = newNum / gcdValue;
+        totalDenominator = newDen / gcdValue;
+    }
+
+    // применяем итоговую формулу
+    int finalNum = base * totalNumerator;
+    int finalDen = (base - 1) * totalDenominator;
+
+    // сокращаем итоговую дробь
+    int finalGCD = findGCD(finalNum, finalDen);
+    return {finalNum / finalGCD, finalDen / finalGCD};
+}
+
+// таблица сумм ряда для одного основания: table[p] = сумма для степени p
+// строится той же рекуррентой, что и computeSeriesSum, но каждая сумма считается один раз.
+// произведения считаются в 64 битах, и если сокращенная дробь не помещается в int,
+// построение останавливается. table - буфер вызывающего на maxPower + 1 элементов,
+// возвращает наибольшую степень, для которой сумма посчитана без переполнения
+int buildSeriesTable(int maxPower, int base, pair<int, int>* table) {
+    table[0] = {1, base - 1}; // базовый случай 1/(b-1)
+
+    // накопленная сумма всех предыдущих членов
+    long long totalNumerator = 0;
+    long long totalDenominator = 1;
+
+    for (int power = 1; power <= maxPower; power++) {
+        // добавляем к накопленной сумме предыдущий член
+        auto [prevNum, prevDen] = table[power - 1];
+        long long newNum = totalNumerator * prevDen + prevNum * totalDenominator;
+        long long newDen = totalDenominator * prevDen;
+        long long gcdValue = gcd(newNum, newDen);
+        totalNumerator = newNum / gcdValue;
+        totalDenominator = newDen / gcdValue;
+
+        // применяем итоговую формулу так же, как в computeSeriesSum
+        long long finalNum = base * totalNumerator;
+        long long finalDen = (base - 1) * totalDenominator;
+        long long finalGCD = gcd(finalNum, finalDen);
+        finalNum /= finalGCD;
+        finalDen /= finalGCD;
+        if (totalNumerator > INT_MAX || totalDenominator > INT_MAX || finalNum > INT_MAX || finalDen > INT_MAX) {
+            return power - 1; // дальше суммы не помещаются в int
+        }
+        table[power] = {static_cast<int>(finalNum), static_cast<int>(finalDen)};
+    }
+    return maxPower;
+}
+
+// функция для определения победителя игры
+// dp[i] = prefix[i] + max(-prefix[j] - dp[j]) по окну j из [i-m, i-1],
+// максимум по скользящему окну поддерживается монотонной очередью, поэтому сложность O(n)
+int findWinner(int n, int m, const int* nums, WinnerArena& arena) {
+    // буферы только растут, память повторно не выделяется для игр не больше прежних
+    if (arena.dp.size() < static_cast<size_t>(n) + 1) {
+        arena.dp.resize(n + 1);
+        arena.prefix.resize(n + 1);
+        arena.window.resize(n + 1);
+    }
+    // dp[i] хранит максимальную разницу очков между текущим игроком и противником
+    // для i оставшихся чисел, суммы 64-битные, чтобы не было переполнения
+    long long* dp = arena.dp.data();
+    long long* prefix = arena.prefix.data();
+    // каждый индекс попадает в очередь один раз, поэтому хватает массива длины n+1
+    int* window = arena.window.data();
+
+    // вычисляем префиксные суммы для быстрого нахождения суммы любых k элементов
+    prefix[0] = 0;
+    for (int i = 1; i <= n; ++i) {
+        prefix[i] = prefix[i - 1] + nums[i - 1];
+    }
+
+    // базовый случай: если чисел не осталось (i=0), разница очков 0
+    dp[0] = 0;
+
+    // очередь индексов j, значения -prefix[j] - dp[j] в ней убывают от начала к концу
+    int head = 0, tail = 0;
+    window[tail++] = 0;
+
+    // заполняем массив dp для всех возможных количеств оставшихся чисел
+    for (int i = 1; i <= n; ++i) {
+        // убираем индексы, которые вышли за окно (взять больше m чисел нельзя)
+        if (window[head] < i - m) {
+            ++head;
+        }
+        // в начале очереди лучший ход: берем числа с j+1 по i
+        int j = window[head];
+        dp[i] = prefix[i] - prefix[j] - dp[j];
+
+        // добавляем i в очередь, выбрасывая индексы с не лучшим значением
+        long long value = -prefix[i] - dp[i];
+        while (tail > head && -prefix[window[tail - 1]] - dp[window[tail - 1]] <= value) {
+            --tail;
+        }
+        window[tail++] = i;
+    }
+
+    return dp[n] < 0 ? 1 : 0;
+}
+
+// вариант для одной игры с собственными буферами
+int findWinner(int n, int m, const vector<int>& nums) {
+    WinnerArena arena;
+    return findWinner(n, m, nums.data(), arena);
+}
+
+// потоковое решение игры
+
+StreamingWinner::StreamingWinner(int m)
+    : m(m), capacity(static_cast<size_t>(m) + 1), indices(capacity), values(capacity) {
+    // базовый случай: для нуля чисел dp = 0 и prefix = 0
+    pushBack(0, 0);
+}
+
+// добавляет очередное число и пересчитывает dp для текущего префикса
+void StreamingWinner::push(int number) {
+    ++count;
+    prefix += number;
+
+    // убираем позицию, которая вышла за окно
+    if (indices[head] < count - m) {
+        head = (head + 1) % capacity;
+        --size;
+    }
+    // лучший ход берем из начала очереди: dp = prefix + max(-prefix[j] - dp[j])
+    dp = prefix + values[head];
+
+    // добавляем текущую позицию, выбрасывая из конца позиции с не лучшим значением
+    long long value = -prefix - dp;
+    while (size > 0 && values[(head + size - 1) % capacity] <= value) {
+        --size;
+    }
+    pushBack(count, value);
+}
+
+// добавляет элемент в конец очереди
+void StreamingWinner::pushBack(long long index, long long value) {
+    size_t pos = (head + size) % capacity;
+    indices[pos] = index;
+    values[pos] = value;
+    ++size;
+}
+
+// решение игры с изменением отдельных чисел
+
+DynamicGame::DynamicGame(int m, const vector<int>& numbers)
+    : n(numbers.size()), m(m), nums(numbers), prefix(n + 1, 0), dp(n + 1, 0), window(n + 1) {
+    // первый расчет целиком
+    dirty = 0;
+    recompute();
+}
+
+// заменяет число с индексом index (с нуля) на value
+void DynamicGame::update(int index, int value) {
+    if (nums[index] == value) return;
+    nums[index] = value;
+    dirty = min(dirty, index);
+}
+
+// победитель для текущей последовательности (1 - павел выиграл, 0 - вика выиграла)
+int DynamicGame::query() {
+    if (dirty < n) recompute();
+    return dp[n] < 0 ? 1 : 0;
+}
+
+// пересчитывает префиксные суммы и dp начиная с первого измененного места
+void DynamicGame::recompute() {
+    int start = dirty + 1;
+
+    // заполняем очередь значениями окна перед start, они не изменились
+    int head = 0, tail = 0;
+    auto push = [&](int j) {
+        long long value = -prefix[j] - dp[j];
+        while (tail > head && -prefix[window[tail - 1]] - dp[window[tail - 1]] <= value) {
+            --tail;
+        }
+        window[tail++] = j;
+    };
+    for (int j = max(0, start - m); j < start; ++j) {
+        push(j);
+    }
+
+    for (int i = start; i <= n; ++i) {
+        prefix[i] = prefix[i - 1] + nums[i - 1];
+        if (window[head] < i - m) {
+            ++head;
+        }
+        int j = window[head];
+        dp[i] = prefix[i] - prefix[j] - dp[j];
+        push(i);
+    }
+
+    dirty = n;
+}
+
+// решает независимые игры параллельно, results[g] - победитель игры g.
+// большие игры раздаются первыми, чтобы каждая досталась отдельному потоку
+// и не оказалась в конце очереди, когда остальные потоки уже простаивают.
+// у каждого потока свои буферы, переиспользуемые между играми.
+// threads = 0 означает количество ядер
+void solveGames(const vector<Game>& games, const int* numbers, char* results, unsigned threads) {
+    vector<int> order(games.size());
+    iota(order.begin(), order.end(), 0);
+    sort(order.begin(), order.end(), [&](int a, int b) { return games[a].n > games[b].n; });
+
+    atomic<size_t> nextGame{0};
+    auto worker = [&]() {
+        WinnerArena arena;
+        for (size_t k = nextGame++; k < order.size(); k = nextGame++) {
+            const Game& game = games[order[k]];
+            results[order[k]] = findWinner(game.n, game.m, numbers + game.offset, arena);
+        }
+    };
+
+    size_t threadCount = threads > 0 ? threads : max(1u, thread::hardware_concurrency());
+    threadCount = min(threadCount, max<size_t>(1, order.size()));
+    vector<thread> pool;
+    for (size_t t = 1; t < threadCount; ++t) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& th : pool) {
+        th.join();
+    }
+}
+
+// наибольшее количество шагов моделирования и интегрирования: при большем шаг
+// несоизмеримо мал по сравнению со временем, это ошибка в параметрах
+const double maxCoolingSteps = 1e9;
+
+// количество строк таблицы: наименьшее steps, при котором steps * step >= time, плюс начальная точка.
+// 0, если time / step не конечно или шагов больше maxCoolingSteps: такое отношение
+// нельзя привести к целому, а таблица получилась бы практически бесконечной
+size_t coolingRows(double time, double step) {
+    double count = ceil(time / step);
+    if (!(count >= 0 && count <= maxCoolingSteps)) return 0;
+    long long steps = static_cast<long long>(count);
+    if (steps > 0 && (steps - 1) * step >= time) --steps;
+    return steps + 1;
+}
+
+// функция для моделирования остывания кофе
+// количество строк известно заранее, каждая точка считается по точной формуле
+// T(t) = tmed + (tcof - tmed) * exp(-k * t), поэтому точки не зависят друг от друга,
+// ошибка округления не накапливается, а цикл векторизуется и распараллеливается
+// точки пишутся в буферы вызывающего times и temps вместимостью capacity,
+// возвращается полное количество строк (если оно больше capacity, записано только capacity).
+// parallel = false отключает распараллеливание, когда параллельны сами вызовы
+size_t cofe(double tcof, double tmed, double k, double time, double step,
+            double* times, double* temps, size_t capacity, [[maybe_unused]] bool parallel) {
+    size_t rows = coolingRows(time, step);
+    size_t filled = min(rows, capacity);
+    double diff = tcof - tmed;
+
+#ifdef _OPENMP
+    #pragma omp parallel for simd if(parallel)
+#endif
+    for (long long i = 0; i < static_cast<long long>(filled); ++i) {
+        double t = i * step;
+        times[i] = t;
+        temps[i] = tmed + diff * exp(-k * t);
+    }
+    return rows;
+}
+
+void cofe(double tcof, double tmed, double k, double time, double step,
+          CoolingData& result, bool parallel) {
+    size_t rows = coolingRows(time, step);
+    result.time.resize(rows);
+    result.temp.resize(rows);
+    cofe(tcof, tmed, k, time, step, result.time.data(), result.temp.data(), rows, parallel);
+}
+
+CoolingData cofe(double tcof, double tmed, double k, double time, double step) {
+    CoolingData result;
+    cofe(tcof, tmed, k, time, step, result);
+    return result;
+}
+
+// температура среды: отрезок профиля ищется двоичным поиском
+double AmbientProfile::operator()(double t) const {
+    if (t <= points.front().first) return points.front().second;
+    if (t >= points.back().first) return points.back().second;
+    // первая точка, время которой не меньше t, - конец нужного отрезка
+    auto next = lower_bound(points.begin(), points.end(), t,
+                            [](const pair<double, double>& point, double value) { return point.first < value; });
+    const auto& [t0, v0] = *(next - 1);
+    const auto& [t1, v1] = *next;
+    return v0 + (v1 - v0) * (t - t0) / (t1 - t0);
+}
+
+// скорость изменения температуры кофе по закону ньютона: dT/dt = -k * (T - tmed(t))
+double coolingRate(double t, double temp, double k, const AmbientProfile& ambient) {
+    return -k * (temp - ambient(t));
+}
+
+// интегрирование методом рунге-кутты 4 порядка с постоянным шагом.
+// возвращает false, если количество шагов не конечно или больше maxCoolingSteps
+bool integrateRK4(double tcof, double k, const AmbientProfile& ambient,
+                  double time, double step, CoolingData& result) {
+    result.time.clear();
+    result.temp.clear();
+    double count = ceil(time / step);
+    if (!(count >= 0 && count <= maxCoolingSteps)) return false;
+
+    double t = 0, temp = tcof;
+    result.time.push_back(t);
+    result.temp.push_back(temp);
+
+    long long steps = static_cast<long long>(count);
+    for (long long i = 1; i <= steps; ++i) {
+        // последний шаг укорачивается, чтобы закончить ровно в time
+        double h = min(step, time - t);
+        double k1 = coolingRate(t, temp, k, ambient);
+        double k2 = coolingRate(t + h / 2, temp + h / 2 * k1, k, ambient);
+        double k3 = coolingRate(t + h / 2, temp + h / 2 * k2, k, ambient);
+        double k4 = coolingRate(t + h, temp + h * k3, k, ambient);
+        temp += h / 6 * (k1 + 2 * k2 + 2 * k3 + k4);
+        t = i == steps ? time : i * step;
+        result.time.push_back(t);
+        result.temp.push_back(temp);
+    }
+    return true;
+}
+
+// интегрирование методом дормана-принса 5(4) с автоматическим выбором шага:
+// на каждом шаге оценивается локальная ошибка по разнице решений 5 и 4 порядка,
+// шаг принимается, если ошибка не больше tolerance (абсолютной и относительной),
+// и новый шаг подбирается по величине ошибки. на пологих участках шаги большие,
+// у резких изменений среды - мелкие. в результат попадают только принятые шаги.
+// возвращает false, если точность меньше minDormandPrinceTolerance (недостижима в double)
+// или расчет не сходится: ошибка не конечна либо шаг стал меньше нескольких ulp времени
+bool integrateDormandPrince(double tcof, double k, const AmbientProfile& ambient,
+                            double time, double tolerance, CoolingData& result) {
+    // коэффициенты таблицы бутчера
+    static const double c[7] = {0, 1.0 / 5, 3.0 / 10, 4.0 / 5, 8.0 / 9, 1, 1};
+    static const double a[7][6] = {
+        {},
+        {1.0 / 5},
+        {3.0 / 40, 9.0 / 40},
+        {44.0 / 45, -56.0 / 15, 32.0 / 9},
+        {19372.0 / 6561, -25360.0 / 2187, 64448.0 / 6561, -212.0 / 729},
+        {9017.0 / 3168, -355.0 / 33, 46732.0 / 5247, 49.0 / 176, -5103.0 / 18656},
+        {35.0 / 384, 0, 500.0 / 1113, 125.0 / 192, -2187.0 / 6784, 11.0 / 84},
+    };
+    // разность весов решений 5 и 4 порядка, дает оценку ошибки
+    static const double e[7] = {
+        35.0 / 384 - 5179.0 / 57600, 0, 500.0 / 1113 - 7571.0 / 16695,
+        125.0 / 192 - 393.0 / 640, -2187.0 / 6784 + 92097.0 / 339200,
+        11.0 / 84 - 187.0 / 2100, -1.0 / 40,
+    };
+
+    result.time.clear();
+    result.temp.clear();
+    if (!(tolerance >= minDormandPrinceTolerance)) return false;
+
+    double t = 0, temp = tcof;
+    result.time.push_back(t);
+    result.temp.push_back(temp);
+
+    double h = min(time, 1.0 / k) / 100; // начальный шаг от характерного времени остывания
+    double stages[7];
+    stages[0] = coolingRate(t, temp, k, ambient);
+
+    while (t < time) {
+        h = min(h, time - t);
+        // при таком шаге время перестает продвигаться, уменьшать его дальше бесполезно
+        if (h < 16 * numeric_limits<double>::epsilon() * max(1.0, fabs(t)) || t + h == t) return false;
+
+        // стадии метода, последняя стадия совпадает с первой следующего шага
+        for (int s = 1; s < 7; ++s) {
+            double y = temp;
+            for (int j = 0; j < s; ++j) y += h * a[s][j] * stages[j];
+            stages[s] = coolingRate(t + c[s] * h, y, k, ambient);
+        }
+        // решение 5 порядка совпадает с точкой последней стадии
+        double next = temp;
+        for (int s = 0; s < 6; ++s) next += h * a[6][s] * stages[s];
+        double error = 0;
+        for (int s = 0; s < 7; ++s) error += h * e[s] * stages[s];
+        double scale = tolerance * (1 + max(fabs(temp), fabs(next)));
+        double ratio = fabs(error) / scale;
+        if (!isfinite(ratio)) return false;
+
+        if (ratio <= 1) {
+            // шаг принят
+            t = (time - t - h <= 1e-12 * time) ? time : t + h;
+            temp = next;
+            stages[0] = stages[6];
+            result.time.push_back(t);
+            result.temp.push_back(temp);
+        }
+        // новый шаг: множитель ограничен, чтобы шаг не менялся скачками
+        double factor = ratio == 0 ? 5 : 0.9 * pow(ratio, -0.2);
+        h *= min(5.0, max(0.2, factor));
+    }
+    return true;
+}
+
+// статистика по куску данных: два прохода по данным, уже лежащим в кэше,
+// без деления внутри цикла, поэтому оба цикла векторизуются
+StatsAccumulator chunkStats(const double* x, const double* y, size_t n) {
+    StatsAccumulator stats;
+    if (n == 0) return stats;
+
+    double sumX = 0, sumY = 0;
+#ifdef _OPENMP
+    #pragma omp simd reduction(+:sumX, sumY)
+#endif
+    for (size_t i = 0; i < n; ++i) {
+        sumX += x[i];
+        sumY += y[i];
+    }
+    stats.count = n;
+    stats.meanX = sumX / n;
+    stats.meanY = sumY / n;
+
+    double m2X = 0, m2Y = 0, cXY = 0;
+#ifdef _OPENMP
+    #pragma omp simd reduction(+:m2X, m2Y, cXY)
+#endif
+    for (size_t i = 0; i < n; ++i) {
+        double dx = x[i] - stats.meanX;
+        double dy = y[i] - stats.meanY;
+        m2X += dx * dx;
+        m2Y += dy * dy;
+        cXY += dx * dy;
+    }
+    stats.m2X = m2X;
+    stats.m2Y = m2Y;
+    stats.cXY = cXY;
+    return stats;
+}
+
+// статистика по всем данным: куски считаются параллельно и объединяются.
+// при parallel = false куски объединяются по ходу, без дополнительной памяти
+StatsAccumulator accumulate(const CoolingData& data, bool parallel) {
+    const size_t chunk = 4096;
+    long long chunks = (data.size() + chunk - 1) / chunk;
+
+    if (!parallel) {
+        StatsAccumulator stats;
+        for (size_t begin = 0; begin < data.size(); begin += chunk) {
+            size_t n = min(chunk, data.size() - begin);
+            stats.merge(chunkStats(data.time.data() + begin, data.temp.data() + begin, n));
+        }
+        return stats;
+    }
+
+    vector<StatsAccumulator> partial(chunks);
+
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for (long long c = 0; c < chunks; ++c) {
+        size_t begin = c * chunk;
+        size_t n = min(chunk, data.size() - begin);
+        partial[c] = chunkStats(data.time.data() + begin, data.temp.data() + begin, n);
+    }
+
+    StatsAccumulator stats;
+    for (const auto& part : partial) {
+        stats.merge(part);
+    }
+    return stats;
+}
+
+// функция для вычисления коэффициента корреляции и детерминации
+void korrel(const StatsAccumulator& stats, double& r, double& r2) {
+    r = stats.correlation();
+    r2 = r * r;
+}
+
+void korrel(const CoolingData& data, double& r, double& r2) {
+    korrel(accumulate(data), r, r2);
+}
+
+// функция для вычисления аппроксимирующей прямой (y = a*x + b)
+void aprox(const StatsAccumulator& stats, double& a, double& b) {
+    a = stats.slope();
+    b = stats.intercept();
+}
+
+void aprox(const CoolingData& data, double& a, double& b) {
+    aprox(accumulate(data), a, b);
+}
+
+// статистика по скользящему окну
+
+// добавляет точку, при заполненном окне вытесняет самую старую
+void RollingStats::add(double x, double y) {
+    size_t pos = total % window;
+    if (count == window) {
+        remove(xs[pos] - anchorX, ys[pos] - anchorY);
+    } else {
+        ++count;
+    }
+    xs[pos] = x;
+    ys[pos] = y;
+    include(x - anchorX, y - anchorY);
+    ++total;
+
+    // периодический пересчет сумм относительно средних окна
+    if (total % window == 0) reanchor();
+}
+
+// коэффициент корреляции по окну
+double RollingStats::correlation() const {
+    double cov = count * sumXY - sumX * sumY;
+    return cov / sqrt((count * sumX2 - sumX * sumX) * (count * sumY2 - sumY * sumY));
+}
+
+// наклон аппроксимирующей прямой по окну
+double RollingStats::slope() const {
+    return (count * sumXY - sumX * sumY) / (count * sumX2 - sumX * sumX);
+}
+
+// свободный член аппроксимирующей прямой по окну
+double RollingStats::intercept() const {
+    double meanX = anchorX + sumX / count;
+    double meanY = anchorY + sumY / count;
+    return meanY - slope() * meanX;
+}
+
+void RollingStats::include(double dx, double dy) {
+    sumX += dx;
+    sumY += dy;
+    sumXY += dx * dy;
+    sumX2 += dx * dx;
+    sumY2 += dy * dy;
+}
+
+void RollingStats::remove(double dx, double dy) {
+    sumX -= dx;
+    sumY -= dy;
+    sumXY -= dx * dy;
+    sumX2 -= dx * dx;
+    sumY2 -= dy * dy;
+}
+
+// переносит опорную точку в средние окна и считает суммы заново
+void RollingStats::reanchor() {
+    anchorX += sumX / count;
+    anchorY += sumY / count;
+    sumX = sumY = sumXY = sumX2 = sumY2 = 0;
+    for (size_t i = 0; i < count; ++i) {
+        include(xs[i] - anchorX, ys[i] - anchorY);
+    }
+}
+
+// буферизованная запись в файл
+
+// записывает произвольные байты
+void BufferedWriter::write(const void* data, size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        if (used == buffer.size()) flush();
+        size_t part = min(size, buffer.size() - used);
+        memcpy(buffer.data() + used, bytes, part);
+        used += part;
+        bytes += part;
+        size -= part;
+    }
+}
+
+// записывает число с фиксированным количеством знаков после запятой
+void BufferedWriter::writeFixed(double value, int precision) {
+    // места с запасом хватает для любого double в фиксированной записи
+    if (buffer.size() - used < 400) flush();
+    char* begin = buffer.data() + used;
+    auto result = to_chars(begin, buffer.data() + buffer.size(), value, chars_format::fixed, precision);
+    used += result.ptr - begin;
+}
+
+// отправляет накопленные данные в файл
+void BufferedWriter::flush() {
+    if (file != nullptr && used > 0) {
+        if (fwrite(buffer.data(), 1, used, file) != used) failed = true;
+    }
+    used = 0;
+}
+
+// дописывает буфер и закрывает файл, возвращает true, если ошибок записи не было
+bool BufferedWriter::close() {
+    if (file == nullptr) return false;
+    flush();
+    if (fclose(file) != 0) failed = true;
+    file = nullptr;
+    return !failed;
+}
+
+// записывает столбец чисел float64 в порядке little-endian
+void writeColumn(BufferedWriter& out, const vector<double>& column) {
+    if constexpr (endian::native == endian::little) {
+        out.write(column.data(), column.size() * sizeof(double));
+    } else {
+        for (double value : column) writeLittleEndian(out, value);
+    }
+}
+
+// функция для записи данных в файл в формате csv
+bool writeCsv(const CoolingData& data, const string& filename) {
+    CsvExporter out(filename);
+    if (!out.isOpen()) return false;
+    for (size_t i = 0; i < data.size(); ++i) {
+        out.row(data.time[i], data.temp[i]);
+    }
+    return out.close();
+}
+
+// записывает заголовок бинарного файла
+void writeBinaryHeader(BufferedWriter& out, uint64_t rows) {
+    BinaryHeader header = {{'C', 'O', 'F', 'E', 'C', 'O', 'L', '\0'}, 1, 2, rows, 0};
+    out.write(header.magic, sizeof(header.magic));
+    writeLittleEndian(out, header.version);
+    writeLittleEndian(out, header.columns);
+    writeLittleEndian(out, header.rows);
+    writeLittleEndian(out, header.reserved);
+}
+
+// функция для записи данных в файл в бинарном столбцовом формате
+bool writeBinary(const CoolingData& data, const string& filename) {
+    BufferedWriter out(filename);
+    if (!out.isOpen()) return false;
+
+    writeBinaryHeader(out, data.size());
+    writeColumn(out, data.time);
+    writeColumn(out, data.temp);
+    return out.close();
+}
+
+// бинарная запись ленивой последовательности: столбцы идут друг за другом,
+// поэтому последовательность проходится дважды, точки не сохраняются
+bool writeBinary(const CoolingRange& range, const string& filename) {
+    BufferedWriter out(filename);
+    if (!out.isOpen()) return false;
+
+    writeBinaryHeader(out, range.size());
+    for (CoolingPoint point : range) writeLittleEndian(out, point.time);
+    for (CoolingPoint point : range) writeLittleEndian(out, point.temp);
+    return out.close();
+}
+
+// двоичный ли формат выбран по имени файла
+bool isBinaryFile(const string& filename) {
+    return filename.size() >= 4 && filename.compare(filename.size() - 4, 4, ".bin") == 0;
+}
+
+// оценка коэффициента остывания и температуры среды по потоку измерений
+
+// добавляет измерение температуры temp в момент t
+void OnlineCoolingFit::add(double t, double temp) {
+    if (count > 0) {
+        dt = t - lastTime;
+        update(lastTemp, temp);
+    }
+    lastTime = t;
+    lastTemp = temp;
+    ++count;
+
+    if (window > 0) {
+        times[filled % window] = t;
+        temps[filled % window] = temp;
+        ++filled;
+        // уточняем оценку каждый раз, когда окно обновилось целиком
+        if (filled >= window && filled % window == 0) refine();
+    }
+}
+
+// оценка коэффициента остывания по рекурсивному методу
+double OnlineCoolingFit::k() const {
+    if (count < 3 || theta[0] <= 0 || dt <= 0) return NAN;
+    return -log(theta[0]) / dt;
+}
+
+// оценка температуры среды по рекурсивному методу
+double OnlineCoolingFit::tmed() const {
+    if (count < 3) return NAN;
+    return theta[1] / (1 - theta[0]);
+}
+
+// шаг рекурсивного метода наименьших квадратов для T[i] = a * T[i-1] + c
+void OnlineCoolingFit::update(double prevTemp, double temp) {
+    double phi[2] = {prevTemp, 1.0};
+    double pphi[2] = {P[0][0] * phi[0] + P[0][1] * phi[1],
+                      P[1][0] * phi[0] + P[1][1] * phi[1]};
+    double denom = lambda + phi[0] * pphi[0] + phi[1] * pphi[1];
+    double gain[2] = {pphi[0] / denom, pphi[1] / denom};
+    double error = temp - (theta[0] * phi[0] + theta[1] * phi[1]);
+    theta[0] += gain[0] * error;
+    theta[1] += gain[1] * error;
+    for (int i = 0; i < 2; ++i) {
+        for (int j = 0; j < 2; ++j) {
+            P[i][j] = (P[i][j] - gain[i] * pphi[j]) / lambda;
+        }
+    }
+}
+
+// решает систему 3x3 методом гаусса, возвращает false для вырожденной системы
+bool OnlineCoolingFit::solve3(double A[3][3], double b[3], double x[3]) {
+    for (int col = 0; col < 3; ++col) {
+        int pivot = col;
+        for (int row = col + 1; row < 3; ++row) {
+            if (fabs(A[row][col]) > fabs(A[pivot][col])) pivot = row;
+        }
+        if (fabs(A[pivot][col]) < 1e-300) return false;
+        swap(A[col], A[pivot]);
+        swap(b[col], b[pivot]);
+        for (int row = col + 1; row < 3; ++row) {
+            double f = A[row][col] / A[col][col];
+            for (int j = col; j < 3; ++j) A[row][j] -= f * A[col][j];
+            b[row] -= f * b[col];
+        }
+    }
+    for (int row = 2; row >= 0; --row) {
+        double sum = b[row];
+        for (int j = row + 1; j < 3; ++j) sum -= A[row][j] * x[j];
+        x[row] = sum / A[row][row];
+    }
+    return true;
+}
+
+// сумма квадратов отклонений модели (tmed, A, k) от точек окна
+double OnlineCoolingFit::residual(const double p[3], double t0) const {
+    double sum = 0;
+    for (size_t i = 0; i < window; ++i) {
+        double r = temps[i] - (p[0] + p[1] * exp(-p[2] * (times[i] - t0)));
+        sum += r * r;
+    }
+    return sum;
+}
+
+// уточнение по окну методом левенберга-марквардта от оценки рекурсивного метода
+void OnlineCoolingFit::refine() {
+    double t0 = times[filled % window]; // самая старая точка окна
+    double p[3];
+    p[0] = tmed();
+    p[2] = k();
+    if (isnan(p[0]) || isnan(p[2])) return;
+    p[1] = temps[filled % window] - p[0];
+
+    double mu = 1e-3;
+    double current = residual(p, t0);
+    for (int iter = 0; iter < 20; ++iter) {
+        // нормальные уравнения J^T J и J^T r
+        double JTJ[3][3] = {}, JTr[3] = {};
+        for (size_t i = 0; i < window; ++i) {
+            double dtime = times[i] - t0;
+            double e = exp(-p[2] * dtime);
+            double J[3] = {1.0, e, -p[1] * dtime * e};
+            double r = temps[i] - (p[0] + p[1] * e);
+            for (int a = 0; a < 3; ++a) {
+                JTr[a] += J[a] * r;
+                for (int b = 0; b < 3; ++b) JTJ[a][b] += J[a] * J[b];
+            }
+        }
+
+        // шаг с демпфированием, mu уменьшается при удаче и растет при неудаче
+        bool improved = false;
+        while (mu < 1e10) {
+            double A[3][3], b[3], delta[3];
+            for (int a = 0; a < 3; ++a) {
+                for (int c = 0; c < 3; ++c) A[a][c] = JTJ[a][c];
+                A[a][a] += mu * JTJ[a][a];
+                b[a] = JTr[a];
+            }
+            if (!solve3(A, b, delta)) {
+                mu *= 10;
+                continue;
+            }
+            double trial[3] = {p[0] + delta[0], p[1] + delta[1], p[2] + delta[2]};
+            double next = residual(trial, t0);
+            if (next < current) {
+                copy(trial, trial + 3, p);
+                improved = current - next > 1e-12 * current;
+                current = next;
+                mu = max(mu / 10, 1e-12);
+                break;
+            }
+            mu *= 10;
+        }
+        if (!improved) break;
+    }
+
+    if (p[2] > 0) {
+        lmTmed = p[0];
+        lmK = p[2];
+    }
+}
+
+// моделирует все сценарии на threads потоках (0 - по количеству ядер) и пишет
+// итоги в results (размер подгоняется под scenarios). у каждого потока свой буфер
+// точек, который переиспользуется между сценариями. onTrace, если задан,
+// вызывается с номером сценария и его точками из потока, который его считал
+void sweepScenarios(const vector<Scenario>& scenarios, vector<SweepResult>& results,
+                    const function<void(size_t, const CoolingData&)>& onTrace, unsigned threads) {
+    results.resize(scenarios.size());
+    atomic<size_t> next{0};
+    auto worker = [&]() {
+        CoolingData data;
+        for (size_t i = next++; i < scenarios.size(); i = next++) {
+            const Scenario& sc = scenarios[i];
+            cofe(sc.tcof, sc.tmed, sc.k, sc.time, sc.step, data, false);
+            StatsAccumulator stats = accumulate(data, false);
+            SweepResult& res = results[i];
+            res.rows = data.size();
+            korrel(stats, res.r, res.r2);
+            aprox(stats, res.a, res.b);
+            if (onTrace) onTrace(i, data);
+        }
+    };
+
+    size_t threadCount = threads > 0 ? threads : max(1u, thread::hardware_concurrency());
+    threadCount = min(threadCount, max<size_t>(1, scenarios.size()));
+    vector<thread> pool;
+    for (size_t t = 1; t < threadCount; ++t) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& th : pool) {
+        th.join();
+    }
+}
+
+} // namespace lr3
@@ -0,0 +1,631 @@
+// вычислительные функции всех программ лабораторной работы в виде библиотеки
+// функции ничего не выводят и не читают с консоли, случайные числа берутся
+// из генератора вызывающего (std::mt19937), результаты пишутся в переданные буферы.
+// сборка статической библиотеки:
+//   g++ -std=c++20 -O2 -c lr3lib.cpp && ar rcs liblr3.a lr3lib.o
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace lr3 {
+
+// ---- lr3-1: кусочная функция
+
+// значение y в зависимости от x, вне [-5, 5] - nan
+double calculateY(double x);
+
+// ---- lr3-2: генерация простых чисел
+
+// быстрое возведение в степень по модулю
+int modPow(int base, int exponent, int modulus);
+
+// простые числа до n решетом эратосфена
+std::vector<int> sieveOfEratosthenes(int n);
+
+// простые числа до 500, из которых строятся кандидаты (таблица строится один раз)
+const std::vector<int>& smallPrimes();
+
+// случайное целое в [min, max] и случайное вещественное в [0, 1) из генератора gen
+int getRandomInt(std::mt19937& gen, int min, int max);
+double getRandomDouble(std::mt19937& gen);
+
+// наибольший общий делитель двух чисел
+int gcdInt(int a, int b);
+
+// сертификат простоты числа n по теореме поклингтона:
+// для каждого простого делителя q числа n-1 указано основание a, такое что
+// a^(n-1) = 1 (mod n) и нод(a^((n-1)/q) - 1, n) = 1. если произведение F
+// степеней этих q в разложении n-1 больше sqrt(n), то n простое.
+// сами q малы и проверяются перебором делителей
+struct PrimeCertificate {
+    int n;
+    std::vector<std::pair<int, int>> witnesses; // пары (q, a)
+};
+
+// простота небольшого числа перебором делителей
+bool isSmallPrime(int q);
+
+// строит сертификат для n по известным простым делителям n-1
+bool buildCertificate(int n, const std::vector<int>& factors, PrimeCertificate& cert);
+
+// проверка сертификата
+bool verifyCertificate(const PrimeCertificate& cert);
+
+// сертификат в виде строки "n q1:a1 q2:a2 ..." и обратно
+std::string formatCertificate(const PrimeCertificate& cert);
+bool parseCertificate(const std::string& line, PrimeCertificate& cert);
+
+// найденное простое число
+struct GeneratedPrime {
+    int prime = 0;             // простое число
+    bool confirmed = false;    // прошло дополнительную проверку миллера-рабина
+    int attempts = 0;          // отвергнуто вероятно простых кандидатов перед ним
+    bool certified = false;    // удалось построить сертификат
+    PrimeCertificate certificate;
+};
+
+// алгоритм поклингтона
+class PocklingtonPrimality {
+public:
+    static bool isPrime(int n, int tests, const std::vector<int>& factors, std::mt19937& gen);
+    static std::tuple<int, std::vector<int>> generateCandidate(const std::vector<int>& primes, int bits,
+                                                               std::mt19937& gen);
+    static void generatePrimes(int bits, int tests, int count, std::mt19937& gen,
+                               std::vector<GeneratedPrime>& found);
+
+private:
+    static bool millerRabinTest(int num, int tests, std::mt19937& gen);
+};
+
+// алгоритм миллера
+class MillerPrimality {
+public:
+    static bool isPrime(int candidate, int testCount, const std::vector<int>& factors, std::mt19937& gen);
+    static std::pair<int, std::vector<int>> generateCandidate(const std::vector<int>& primes, int bitLength,
+                                                              std::mt19937& gen);
+    static void generatePrimes(int bitLength, int testCount, int targetCount, std::mt19937& gen,
+                               std::vector<GeneratedPrime>& found);
+    static bool millerRabinTest(int num, int count, std::mt19937& gen);
+};
+
+// алгоритм гост р 34.10-94
+class GOSTPrimality {
+public:
+    static int generatePrime(const std::vector<int>& primes, int bitLen, std::mt19937& gen);
+    static int generatePrimes(int bitLength, int testRounds, int targetCount, std::mt19937& gen,
+                              std::vector<int>& found,
+                              const std::function<void(size_t, size_t)>& progress = nullptr);
+
+private:
+    static bool millerRabinTest(int num, int tests, std::mt19937& gen);
+};
+
+// ---- lr3-3: сумма ряда
+
+// наибольший общий делитель двух чисел
+int findGCD(int firstNum, int secondNum);
+
+// сумма ряда в виде дроби (числитель, знаменатель)
+std::pair<int, int> computeSeriesSum(int power, int base);
+
+// суммы ряда для степеней 0..maxPower в буфер table на maxPower + 1 элементов,
+// возвращает наибольшую степень, сумма для которой помещается в int
+int buildSeriesTable(int maxPower, int base, std::pair<int, int>* table);
+
+// ---- lr3-4: игра с числами
+
+// рабочие буферы решателя, переиспользуются между играми, чтобы не выделять память заново
+struct WinnerArena {
+    std::vector<long long> dp;      // dp[i] для i оставшихся чисел
+    std::vector<long long> prefix;  // префиксные суммы
+    std::vector<int> window;        // монотонная очередь индексов
+};
+
+// победитель игры (1 - павел выиграл, 0 - вика выиграла)
+int findWinner(int n, int m, const int* nums, WinnerArena& arena);
+int findWinner(int n, int m, const std::vector<int>& nums);
+
+// потоковое решение игры: числа подаются по одному, память O(m)
+// хранится только текущая префиксная сумма и монотонная очередь по окну
+// из последних m позиций в виде кольцевых буферов.
+// окно длиннее последовательности не нужно, поэтому при известном n передается min(m, n)
+class StreamingWinner {
+public:
+    explicit StreamingWinner(int m);
+
+    // добавляет очередное число и пересчитывает dp для текущего префикса
+    void push(int number);
+
+    // победитель для уже поданных чисел (1 - павел выиграл, 0 - вика выиграла)
+    int winner() const {
+        return dp < 0 ? 1 : 0;
+    }
+
+private:
+    // добавляет элемент в конец очереди
+    void pushBack(long long index, long long value);
+
+    int m;                           // максимальное количество чисел за ход
+    size_t capacity;                 // размер кольцевых буферов
+    std::vector<long long> indices;  // номера позиций в очереди
+    std::vector<long long> values;   // значения -prefix[j] - dp[j] в очереди
+    size_t head = 0;                 // начало очереди в кольцевом буфере
+    size_t size = 0;                 // количество элементов в очереди
+    long long count = 0;             // сколько чисел уже подано
+    long long prefix = 0;            // сумма поданных чисел
+    long long dp = 0;                // dp для текущего префикса
+};
+
+// решение игры с изменением отдельных чисел последовательности
+// update меняет одно число за O(1), query возвращает победителя для текущей последовательности.
+// префиксные суммы и dp пересчитываются в query только начиная с первого числа,
+// измененного после прошлого запроса, так что несколько изменений подряд дают один пересчет
+class DynamicGame {
+public:
+    DynamicGame(int m, const std::vector<int>& numbers);
+
+    // заменяет число с индексом index (с нуля) на value
+    void update(int index, int value);
+
+    // победитель для текущей последовательности (1 - павел выиграл, 0 - вика выиграла)
+    int query();
+
+private:
+    // пересчитывает префиксные суммы и dp начиная с первого измененного места
+    void recompute();
+
+    int n;                            // длина последовательности
+    int m;                            // максимальное количество чисел за ход
+    std::vector<int> nums;            // текущая последовательность
+    std::vector<long long> prefix;    // префиксные суммы
+    std::vector<long long> dp;        // dp[i] для i оставшихся чисел
+    std::vector<int> window;          // монотонная очередь индексов для пересчета
+    int dirty = 0;                    // первое измененное число после последнего пересчета
+};
+
+// одна игра из пакета: числа лежат в общем массиве начиная с offset
+struct Game {
+    size_t offset;
+    int n;
+    int m;
+};
+
+// решает независимые игры параллельно, results[g] - победитель игры g
+void solveGames(const std::vector<Game>& games, const int* numbers, char* results, unsigned threads = 0);
+
+// ---- lr3-5: остывание кофе
+
+// результаты моделирования: время и температура в отдельных непрерывных массивах
+struct CoolingData {
+    std::vector<double> time;
+    std::vector<double> temp;
+
+    size_t size() const {
+        return time.size();
+    }
+};
+
+// количество строк таблицы моделирования, 0 - time / step не конечно или слишком велико
+size_t coolingRows(double time, double step);
+
+// моделирование остывания в буферы вызывающего, возвращает полное количество строк
+// (0 и пустой результат при недопустимых time и step, как у coolingRows)
+size_t cofe(double tcof, double tmed, double k, double time, double step,
+            double* times, double* temps, size_t capacity, bool parallel = true);
+// моделирование остывания в result, память result переиспользуется
+void cofe(double tcof, double tmed, double k, double time, double step,
+          CoolingData& result, bool parallel = true);
+CoolingData cofe(double tcof, double tmed, double k, double time, double step);
+
+// точка моделирования
+struct CoolingPoint {
+    double time;
+    double temp;
+};
+
+// ленивая последовательность точек моделирования: те же значения, что дает cofe,
+// но каждая точка вычисляется при обращении и нигде не хранится.
+// по последовательности можно пройти сколько угодно раз, память O(1).
+// при недопустимых time и step (coolingRows дает 0) последовательность пуста
+class CoolingRange {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = CoolingPoint;
+        using difference_type = ptrdiff_t;
+        using pointer = void;
+        using reference = CoolingPoint;
+
+        iterator(const CoolingRange* range, size_t index) : range(range), index(index) {}
+
+        CoolingPoint operator*() const {
+            double t = index * range->step;
+            return {t, range->tmed + range->diff * std::exp(-range->k * t)};
+        }
+
+        iterator& operator++() {
+            ++index;
+            return *this;
+        }
+
+        bool operator==(const iterator& other) const {
+            return index == other.index;
+        }
+
+        bool operator!=(const iterator& other) const {
+            return index != other.index;
+        }
+
+    private:
+        const CoolingRange* range;
+        size_t index;
+    };
+
+    CoolingRange(double tcof, double tmed, double k, double time, double step)
+        : tmed(tmed), diff(tcof - tmed), k(k), step(step), rows(coolingRows(time, step)) {}
+
+    iterator begin() const {
+        return {this, 0};
+    }
+
+    iterator end() const {
+        return {this, rows};
+    }
+
+    size_t size() const {
+        return rows;
+    }
+
+private:
+    double tmed;  // температура среды
+    double diff;  // начальная разница температур кофе и среды
+    double k;     // коэффициент остывания
+    double step;  // шаг по времени
+    size_t rows;  // количество точек
+};
+
+// температура окружающей среды как функция времени: постоянная
+// или кусочно-линейная по точкам (время, температура), вне точек - крайние значения.
+// запрос не меняет состояния, поэтому один профиль можно читать из нескольких потоков
+class AmbientProfile {
+public:
+    explicit AmbientProfile(double constant = 0) : points{{0.0, constant}} {}
+
+    // кусочно-линейный профиль по точкам, время в points должно возрастать
+    explicit AmbientProfile(std::vector<std::pair<double, double>> points) : points(std::move(points)) {}
+
+    // температура среды в момент t
+    double operator()(double t) const;
+
+private:
+    std::vector<std::pair<double, double>> points;
+};
+
+// скорость изменения температуры: dT/dt = -k * (T - tmed(t))
+double coolingRate(double t, double temp, double k, const AmbientProfile& ambient);
+
+// интегрирование рунге-куттой 4 порядка с постоянным шагом,
+// false - слишком много шагов
+bool integrateRK4(double tcof, double k, const AmbientProfile& ambient,
+                  double time, double step, CoolingData& result);
+
+// наименьшая точность дормана-принса: меньшая не достижима в double
+const double minDormandPrinceTolerance = 1e-15;
+
+// интегрирование дорманом-принсом 5(4) с автоматическим выбором шага,
+// false - точность меньше minDormandPrinceTolerance или шаг перестал продвигать время
+bool integrateDormandPrince(double tcof, double k, const AmbientProfile& ambient,
+                            double time, double tolerance, CoolingData& result);
+
+// накопитель статистики по точкам (x, y) за один проход
+// хранит средние и центральные моменты (метод уэлфорда), а не сырые суммы,
+// поэтому r и коэффициенты прямой не теряют точность на длинных рядах.
+// два накопителя можно объединить, так что куски данных считаются независимо
+struct StatsAccumulator {
+    double count = 0;  // количество точек
+    double meanX = 0;  // среднее x
+    double meanY = 0;  // среднее y
+    double m2X = 0;    // сумма (x - meanX)^2
+    double m2Y = 0;    // сумма (y - meanY)^2
+    double cXY = 0;    // сумма (x - meanX) * (y - meanY)
+
+    // добавляет одну точку
+    void add(double x, double y) {
+        count += 1;
+        double dx = x - meanX;
+        meanX += dx / count;
+        double dy = y - meanY;
+        meanY += dy / count;
+        m2X += dx * (x - meanX);
+        m2Y += dy * (y - meanY);
+        cXY += dx * (y - meanY);
+    }
+
+    // объединяет с накопителем по другому куску данных (формулы чана)
+    void merge(const StatsAccumulator& other) {
+        if (other.count == 0) return;
+        if (count == 0) {
+            *this = other;
+            return;
+        }
+        double total = count + other.count;
+        double dx = other.meanX - meanX;
+        double dy = other.meanY - meanY;
+        double weight = count * other.count / total;
+        m2X += other.m2X + dx * dx * weight;
+        m2Y += other.m2Y + dy * dy * weight;
+        cXY += other.cXY + dx * dy * weight;
+        meanX += dx * other.count / total;
+        meanY += dy * other.count / total;
+        count = total;
+    }
+
+    // коэффициент корреляции
+    double correlation() const {
+        return cXY / std::sqrt(m2X * m2Y);
+    }
+
+    // наклон аппроксимирующей прямой
+    double slope() const {
+        return cXY / m2X;
+    }
+
+    // свободный член аппроксимирующей прямой
+    double intercept() const {
+        return meanY - slope() * meanX;
+    }
+};
+
+// статистика по скользящему окну из последних window точек: при добавлении
+// точки ее вклад прибавляется к суммам, а вклад вытесненной точки вычитается,
+// так что обновление стоит O(1). суммы хранятся для значений, сдвинутых на опорную
+// точку, и раз в window точек пересчитываются заново относительно текущих средних,
+// чтобы ошибка от вычитаний не накапливалась
+class RollingStats {
+public:
+    explicit RollingStats(size_t window) : window(window), xs(window), ys(window) {}
+
+    // добавляет точку, при заполненном окне вытесняет самую старую
+    void add(double x, double y);
+
+    // заполнено ли окно
+    bool full() const {
+        return count == window;
+    }
+
+    // коэффициент корреляции по окну
+    double correlation() const;
+
+    // наклон аппроксимирующей прямой по окну
+    double slope() const;
+
+    // свободный член аппроксимирующей прямой по окну
+    double intercept() const;
+
+private:
+    void include(double dx, double dy);
+
+    void remove(double dx, double dy);
+
+    // переносит опорную точку в средние окна и считает суммы заново
+    void reanchor();
+
+    size_t window;              // размер окна
+    std::vector<double> xs, ys; // кольцевые буферы точек окна
+    size_t count = 0;           // точек в окне
+    size_t total = 0;           // всего добавлено точек
+    double anchorX = 0;         // опорные значения, от которых считаются суммы
+    double anchorY = 0;
+    double sumX = 0, sumY = 0, sumXY = 0, sumX2 = 0, sumY2 = 0;
+};
+
+// статистика по куску данных и по всем данным
+StatsAccumulator chunkStats(const double* x, const double* y, size_t n);
+StatsAccumulator accumulate(const CoolingData& data, bool parallel = true);
+
+// коэффициенты корреляции и детерминации
+void korrel(const StatsAccumulator& stats, double& r, double& r2);
+void korrel(const CoolingData& data, double& r, double& r2);
+
+// аппроксимирующая прямая y = a*x + b
+void aprox(const StatsAccumulator& stats, double& a, double& b);
+void aprox(const CoolingData& data, double& a, double& b);
+
+// буферизованная запись в файл: данные копируются в большой буфер
+// и уходят в файл крупными блоками, числа форматируются через to_chars
+class BufferedWriter {
+public:
+    explicit BufferedWriter(const std::string& filename, size_t bufferSize = 1 << 20)
+        : file(fopen(filename.c_str(), "wb")), buffer(bufferSize) {}
+
+    ~BufferedWriter() {
+        close();
+    }
+
+    BufferedWriter(const BufferedWriter&) = delete;
+    BufferedWriter& operator=(const BufferedWriter&) = delete;
+
+    // открыт ли файл
+    bool isOpen() const {
+        return file != nullptr;
+    }
+
+    // записывает произвольные байты
+    void write(const void* data, size_t size);
+
+    void write(const std::string& text) {
+        write(text.data(), text.size());
+    }
+
+    void put(char c) {
+        if (used == buffer.size()) flush();
+        buffer[used++] = c;
+    }
+
+    // записывает число с фиксированным количеством знаков после запятой
+    void writeFixed(double value, int precision);
+
+    // отправляет накопленные данные в файл
+    void flush();
+
+    // дописывает буфер и закрывает файл, возвращает true, если ошибок записи не было
+    bool close();
+
+private:
+    FILE* file;
+    std::vector<char> buffer;
+    size_t used = 0;
+    bool failed = false;
+};
+
+// заголовок бинарного файла: 32 байта, затем столбцы времени и температуры
+// по rows чисел float64 в порядке little-endian. столбцы выровнены на 8 байт,
+// поэтому файл можно отобразить в память и читать как массивы double без копирования
+struct BinaryHeader {
+    char magic[8];      // "COFECOL" и нулевой байт
+    uint32_t version;   // версия формата, сейчас 1
+    uint32_t columns;   // количество столбцов, сейчас 2 (время, температура)
+    uint64_t rows;      // количество строк
+    uint64_t reserved;  // зарезервировано, 0
+};
+static_assert(sizeof(BinaryHeader) == 32, "заголовок должен занимать 32 байта");
+
+// записывает число в порядке little-endian
+template <typename T>
+void writeLittleEndian(BufferedWriter& out, T value) {
+    unsigned char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    if constexpr (std::endian::native == std::endian::big) {
+        std::reverse(bytes, bytes + sizeof(T));
+    }
+    out.write(bytes, sizeof(T));
+}
+
+// записывает столбец чисел float64 в порядке little-endian
+void writeColumn(BufferedWriter& out, const std::vector<double>& column);
+
+// построчная запись csv: строки добавляются по мере вычисления
+class CsvExporter {
+public:
+    explicit CsvExporter(const std::string& filename) : out(filename) {
+        if (out.isOpen()) out.write(std::string("время (мин),температура (C)\n"));
+    }
+
+    bool isOpen() const {
+        return out.isOpen();
+    }
+
+    void row(double time, double temp) {
+        out.writeFixed(time, 2);
+        out.put(',');
+        out.writeFixed(temp, 1);
+        out.put('\n');
+    }
+
+    bool close() {
+        return out.close();
+    }
+
+private:
+    BufferedWriter out;
+};
+
+// запись в csv и в бинарный столбцовый формат, true при успехе
+bool writeCsv(const CoolingData& data, const std::string& filename);
+void writeBinaryHeader(BufferedWriter& out, uint64_t rows);
+bool writeBinary(const CoolingData& data, const std::string& filename);
+bool writeBinary(const CoolingRange& range, const std::string& filename);
+
+// двоичный ли формат выбран по имени файла (.bin)
+bool isBinaryFile(const std::string& filename);
+
+// оценка коэффициента остывания и температуры среды по потоку измерений.
+// при равномерном шаге dt закон остывания дает линейную связь соседних точек:
+// T[i] = a * T[i-1] + c, где a = exp(-k * dt), c = tmed * (1 - a).
+// a и c оцениваются рекурсивным методом наименьших квадратов за O(1) на точку,
+// коэффициент забывания lambda < 1 позволяет следить за меняющимися условиями.
+// при window > 0 по последним window точкам периодически уточняется
+// нелинейная модель T = tmed + A * exp(-k * (t - t0)) методом левенберга-марквардта
+class OnlineCoolingFit {
+public:
+    explicit OnlineCoolingFit(size_t window = 0, double lambda = 1.0)
+        : lambda(lambda), window(window), times(window), temps(window) {}
+
+    // добавляет измерение температуры temp в момент t
+    void add(double t, double temp);
+
+    // оценка коэффициента остывания по рекурсивному методу
+    double k() const;
+
+    // оценка температуры среды по рекурсивному методу
+    double tmed() const;
+
+    // оценки после последнего уточнения по окну (nan, пока уточнения не было)
+    double refinedK() const {
+        return lmK;
+    }
+
+    double refinedTmed() const {
+        return lmTmed;
+    }
+
+private:
+    // шаг рекурсивного метода наименьших квадратов для T[i] = a * T[i-1] + c
+    void update(double prevTemp, double temp);
+
+    // решает систему 3x3 методом гаусса, возвращает false для вырожденной системы
+    static bool solve3(double A[3][3], double b[3], double x[3]);
+
+    // сумма квадратов отклонений модели (tmed, A, k) от точек окна
+    double residual(const double p[3], double t0) const;
+
+    // уточнение по окну методом левенберга-марквардта от оценки рекурсивного метода
+    void refine();
+
+    double lambda;                 // коэффициент забывания
+    double theta[2] = {1.0, 0.0};  // оценки a и c
+    double P[2][2] = {{1e6, 0}, {0, 1e6}}; // ковариация оценок
+    size_t count = 0;              // количество полученных точек
+    double lastTime = 0;           // время предыдущей точки
+    double lastTemp = 0;           // температура предыдущей точки
+    double dt = 0;                 // шаг между последними точками
+
+    size_t window;                 // размер окна для уточнения, 0 - без уточнения
+    std::vector<double> times;     // кольцевой буфер времени
+    std::vector<double> temps;     // кольцевой буфер температуры
+    size_t filled = 0;             // сколько точек прошло через окно
+    double lmK = NAN;              // уточненный коэффициент остывания
+    double lmTmed = NAN;           // уточненная температура среды
+};
+
+// сценарий моделирования
+struct Scenario {
+    double tcof, tmed, k, time, step;
+};
+
+// итоги моделирования одного сценария
+struct SweepResult {
+    size_t rows;
+    double r, r2, a, b;
+};
+
+// моделирует все сценарии параллельно, итоги в results
+void sweepScenarios(const std::vector<Scenario>& scenarios, std::vector<SweepResult>& results,
+                    const std::function<void(size_t, const CoolingData&)>& onTrace = nullptr,
+                    unsigned threads = 0);
+
+} // namespace lr3